@@ -0,0 +1,153 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <atomic>
+#include <new>
+
+// Process-wide counters for every Arena, shown by report-util
+struct ArenaStats {
+    std::atomic<long long> arenas_live{0};
+    std::atomic<long long> chunks_allocated{0};
+    std::atomic<long long> chunks_released{0};
+    std::atomic<long long> bytes_reserved{0}; // Currently held in chunks
+    std::atomic<long long> bytes_used{0};     // Currently handed out
+    std::atomic<long long> allocations{0};    // Total allocate() calls
+};
+
+inline ArenaStats& arenaStats() {
+    static ArenaStats stats;
+    return stats;
+}
+
+// Bump allocator owned by one process. Memory is carved out of a chain of
+// growing chunks and only given back all at once by release().
+class Arena {
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t capacity;
+    };
+    
+    static const size_t MAX_CHUNK_SIZE = 1 << 20;
+    
+    Chunk* head;
+    char* cursor;
+    char* limit;
+    size_t next_chunk_size;
+    size_t reserved;
+    size_t used;
+    
+public:
+    explicit Arena(size_t first_chunk_size = 1024)
+        : head(nullptr), cursor(nullptr), limit(nullptr),
+          next_chunk_size(first_chunk_size), reserved(0), used(0) {
+        arenaStats().arenas_live++;
+    }
+    
+    ~Arena() {
+        release();
+        arenaStats().arenas_live--;
+    }
+    
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        char* start = alignUp(cursor, alignment);
+        if (!head || start + bytes > limit) {
+            addChunk(bytes + alignment);
+            start = alignUp(cursor, alignment);
+        }
+        
+        cursor = start + bytes;
+        used += bytes;
+        arenaStats().bytes_used += bytes;
+        arenaStats().allocations++;
+        return start;
+    }
+    
+    const char* copyString(const std::string& text) {
+        char* copy = static_cast<char*>(allocate(text.size() + 1, 1));
+        std::memcpy(copy, text.c_str(), text.size() + 1);
+        return copy;
+    }
+    
+    // Free every chunk in one shot. Anything allocated here becomes invalid.
+    void release() {
+        while (head) {
+            Chunk* next = head->next;
+            ::operator delete(head);
+            head = next;
+            arenaStats().chunks_released++;
+        }
+        
+        arenaStats().bytes_reserved -= reserved;
+        arenaStats().bytes_used -= used;
+        cursor = nullptr;
+        limit = nullptr;
+        reserved = 0;
+        used = 0;
+    }
+    
+    size_t bytesReserved() const { return reserved; }
+    size_t bytesUsed() const { return used; }
+    
+private:
+    static char* alignUp(char* pointer, size_t alignment) {
+        size_t address = reinterpret_cast<size_t>(pointer);
+        return reinterpret_cast<char*>((address + alignment - 1) & ~(alignment - 1));
+    }
+    
+    void addChunk(size_t min_bytes) {
+        size_t capacity = next_chunk_size;
+        while (capacity < min_bytes) {
+            capacity *= 2;
+        }
+        if (next_chunk_size < MAX_CHUNK_SIZE) {
+            next_chunk_size *= 2;
+        }
+        
+        Chunk* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + capacity));
+        chunk->next = head;
+        chunk->capacity = capacity;
+        head = chunk;
+        cursor = reinterpret_cast<char*>(chunk + 1);
+        limit = cursor + capacity;
+        
+        reserved += sizeof(Chunk) + capacity;
+        arenaStats().bytes_reserved += sizeof(Chunk) + capacity;
+        arenaStats().chunks_allocated++;
+    }
+};
+
+// STL allocator handing out arena memory. deallocate() is a no-op; storage
+// comes back when the arena is released.
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    
+    Arena* arena;
+    
+    explicit ArenaAllocator(Arena& owner) : arena(&owner) {}
+    
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+    
+    T* allocate(size_t count) {
+        return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    
+    void deallocate(T*, size_t) {}
+    
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+#endif
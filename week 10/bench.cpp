@@ -0,0 +1,245 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include "scheduler.h"
+#include "config.h"
+
+// Headless benchmark: runs the scheduler in fast mode for a fixed number of
+// ticks and prints what it measured as JSON (or a table with --table).
+// usage: bench [--config config.txt] [--ticks N] [--seed S] [--table]
+//              [--sweep key=v1,v2,...]...
+// Each --sweep multiplies the runs, e.g. --sweep num-cpu=1,2,4
+// --sweep quantum-cycles=2,8 --sweep mem-per-proc=1024,4096 is 12 runs.
+// Every run uses the same seed, so they all see the same workload.
+
+struct SweepAxis {
+    std::string key;
+    std::vector<std::string> values;
+};
+
+struct BenchResult {
+    std::vector<std::pair<std::string, std::string>> settings; // Swept values of this run
+    Config config;
+    long long ticks = 0;
+    double seconds = 0.0;
+    long long instructions = 0;
+    size_t finished = 0;
+    double avg_turnaround = 0.0;
+    double avg_waiting = 0.0;
+    long long memory_admissions = 0;
+    long long memory_deferrals = 0;
+    size_t fragmentation_kb = 0;
+    double avg_fragmentation_kb = 0.0;
+    
+    struct PhaseLatency {
+        double p50_us;
+        double p99_us;
+        double max_us;
+    };
+    PhaseLatency phases[TickProfiler::PHASES];
+    
+    double ticksPerSecond() const { return seconds > 0 ? ticks / seconds : 0.0; }
+    double instructionsPerSecond() const { return seconds > 0 ? instructions / seconds : 0.0; }
+};
+
+BenchResult runBenchmark(const Config& config, long long ticks) {
+    // Same ids, same process seeds: keeps the workload identical across runs
+    Process::resetIds();
+    Scheduler scheduler;
+    scheduler.initialize(config);
+    
+    auto start = std::chrono::steady_clock::now();
+    scheduler.runTicks(ticks);
+    auto end = std::chrono::steady_clock::now();
+    
+    auto stats = scheduler.getStats();
+    BenchResult result;
+    result.config = config;
+    result.ticks = stats->tick;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.instructions = stats->instructions_executed;
+    result.finished = stats->finished_count;
+    result.avg_turnaround = stats->averageTurnaround();
+    result.avg_waiting = stats->averageWaiting();
+    result.memory_admissions = stats->memory_admissions;
+    result.memory_deferrals = stats->memory_deferrals;
+    result.fragmentation_kb = scheduler.getTotalExternalFragmentation();
+    result.avg_fragmentation_kb = stats->averageFragmentation();
+    for (int i = 0; i < TickProfiler::PHASES; i++) {
+        const LatencyHistogram& histogram = scheduler.getProfiler().histogram(static_cast<TickPhase>(i));
+        result.phases[i].p50_us = histogram.percentile(50) / 1000.0;
+        result.phases[i].p99_us = histogram.percentile(99) / 1000.0;
+        result.phases[i].max_us = histogram.max() / 1000.0;
+    }
+    return result;
+}
+
+void writeJson(std::ostream& out, const BenchResult& result, const std::string& indent) {
+    out << indent << "{\n";
+    for (const auto& setting : result.settings) {
+        out << indent << "  \"" << setting.first << "\": \"" << setting.second << "\",\n";
+    }
+    out << indent << "  \"seed\": " << result.config.seed << ",\n";
+    out << indent << "  \"num_cpu\": " << result.config.num_cpu << ",\n";
+    out << indent << "  \"scheduler\": \"" << result.config.scheduler << "\",\n";
+    out << indent << "  \"ticks\": " << result.ticks << ",\n";
+    out << indent << "  \"seconds\": " << result.seconds << ",\n";
+    out << indent << "  \"ticks_per_sec\": " << result.ticksPerSecond() << ",\n";
+    out << indent << "  \"instructions\": " << result.instructions << ",\n";
+    out << indent << "  \"instructions_per_sec\": " << result.instructionsPerSecond() << ",\n";
+    out << indent << "  \"processes_finished\": " << result.finished << ",\n";
+    out << indent << "  \"avg_turnaround_ticks\": " << result.avg_turnaround << ",\n";
+    out << indent << "  \"avg_waiting_ticks\": " << result.avg_waiting << ",\n";
+    out << indent << "  \"memory_admissions\": " << result.memory_admissions << ",\n";
+    out << indent << "  \"memory_deferrals\": " << result.memory_deferrals << ",\n";
+    out << indent << "  \"external_fragmentation_kb\": " << result.fragmentation_kb << ",\n";
+    out << indent << "  \"avg_external_fragmentation_kb\": " << result.avg_fragmentation_kb << ",\n";
+    out << indent << "  \"phases\": {\n";
+    for (int i = 0; i < TickProfiler::PHASES; i++) {
+        const BenchResult::PhaseLatency& phase = result.phases[i];
+        out << indent << "    \"" << tickPhaseName(static_cast<TickPhase>(i)) << "\": {\"p50_us\": " << phase.p50_us
+            << ", \"p99_us\": " << phase.p99_us << ", \"max_us\": " << phase.max_us << "}"
+            << (i + 1 < TickProfiler::PHASES ? ",\n" : "\n");
+    }
+    out << indent << "  }\n";
+    out << indent << "}";
+}
+
+void writeTable(std::ostream& out, const std::vector<BenchResult>& results) {
+    std::vector<std::string> columns;
+    if (!results.empty()) {
+        for (const auto& setting : results[0].settings) {
+            columns.push_back(setting.first);
+        }
+    }
+    const char* metrics[] = {"ticks/s", "instr/s", "finished", "turnaround", "waiting",
+                             "mem-admit", "mem-defer", "avg-frag-kb"};
+    
+    for (const auto& column : columns) {
+        out << std::setw(16) << column;
+    }
+    for (const char* metric : metrics) {
+        out << std::setw(14) << metric;
+    }
+    out << "\n";
+    
+    for (const BenchResult& result : results) {
+        for (const auto& setting : result.settings) {
+            out << std::setw(16) << setting.second;
+        }
+        out << std::setw(14) << static_cast<long long>(result.ticksPerSecond())
+            << std::setw(14) << static_cast<long long>(result.instructionsPerSecond())
+            << std::setw(14) << result.finished
+            << std::setw(14) << result.avg_turnaround
+            << std::setw(14) << result.avg_waiting
+            << std::setw(14) << result.memory_admissions
+            << std::setw(14) << result.memory_deferrals
+            << std::setw(14) << result.avg_fragmentation_kb << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string config_path = "config.txt";
+    long long ticks = 10000;
+    unsigned long long seed = 0;
+    bool table = false;
+    std::vector<SweepAxis> axes;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::stoll(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        } else if (arg == "--table") {
+            table = true;
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t equals = spec.find('=');
+            if (equals == std::string::npos) {
+                std::cerr << "Bad sweep " << spec << ", expected key=v1,v2,...\n";
+                return 1;
+            }
+            SweepAxis axis;
+            axis.key = spec.substr(0, equals);
+            std::istringstream values(spec.substr(equals + 1));
+            std::string value;
+            while (std::getline(values, value, ',')) {
+                axis.values.push_back(value);
+            }
+            Config check;
+            if (axis.values.empty() || !setConfigValue(check, axis.key, axis.values[0])) {
+                std::cerr << "Cannot sweep " << spec << "\n";
+                return 1;
+            }
+            axes.push_back(axis);
+        } else {
+            std::cerr << "usage: bench [--config config.txt] [--ticks N] [--seed S] [--table] "
+                      << "[--sweep key=v1,v2,...]...\n";
+            return 1;
+        }
+    }
+    
+    Config base;
+    if (!loadConfigFile(config_path, base)) {
+        std::cerr << "Cannot open " << config_path << ", using default values\n";
+    }
+    base.trace_mode = "off";
+    if (seed != 0) {
+        base.seed = seed;
+    }
+    if (base.seed == 0) {
+        // Pick one for all runs, and print it so the sweep can be repeated
+        std::random_device rd;
+        base.seed = (static_cast<unsigned long long>(rd()) << 32) | rd();
+    }
+    
+    // Walk every combination of the swept values, last axis fastest
+    std::vector<BenchResult> results;
+    std::vector<size_t> position(axes.size(), 0);
+    while (true) {
+        Config config = base;
+        std::vector<std::pair<std::string, std::string>> settings;
+        for (size_t a = 0; a < axes.size(); a++) {
+            const std::string& value = axes[a].values[position[a]];
+            setConfigValue(config, axes[a].key, value);
+            settings.push_back(std::make_pair(axes[a].key, value));
+        }
+        
+        results.push_back(runBenchmark(config, ticks));
+        results.back().settings = settings;
+        
+        size_t a = axes.size();
+        while (a > 0 && ++position[a - 1] == axes[a - 1].values.size()) {
+            position[a - 1] = 0;
+            a--;
+        }
+        if (a == 0) {
+            break;
+        }
+    }
+    
+    std::cout << std::fixed << std::setprecision(2);
+    if (table) {
+        std::cout << "seed " << base.seed << ", " << ticks << " ticks per run\n";
+        writeTable(std::cout, results);
+    } else if (axes.empty()) {
+        writeJson(std::cout, results[0], "");
+        std::cout << "\n";
+    } else {
+        std::cout << "[\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            writeJson(std::cout, results[i], "  ");
+            std::cout << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        std::cout << "]\n";
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "bytecode.h"
+#include "string_table.h"
+
+namespace {
+
+// Literal operands become immediates, resolved variables a slot. A variable
+// that never made it into the symbol table reads as 0.
+uint32_t operand(const Instruction& inst, int arg, uint8_t slot_flag, uint8_t& flags) {
+    int32_t literal = symbolTable().literal(inst.args[arg]);
+    if (literal >= 0) {
+        return static_cast<uint16_t>(literal);
+    }
+    if (inst.arg_slots[arg] != NO_VARIABLE_SLOT) {
+        flags |= slot_flag;
+        return inst.arg_slots[arg];
+    }
+    return 0;
+}
+
+// Numeric value of a literal argument, 0 if it is missing or a name
+uint32_t literalArg(const Instruction& inst, int arg) {
+    if (inst.arg_count <= arg) {
+        return 0;
+    }
+    int32_t literal = symbolTable().literal(inst.args[arg]);
+    return literal >= 0 ? static_cast<uint32_t>(literal) : 0;
+}
+    
+} // namespace
+
+void ProgramCompiler::append(const Instruction& inst, ArenaVector<ByteOp>& code, uint32_t index) {
+    ByteOp op = {OpCode::PRINT, 0, 0, 0, 0};
+    
+    switch (inst.type) {
+        case InstructionType::PRINT:
+            op.op = OpCode::PRINT;
+            op.a = inst.arg_count > 0 ? inst.args[0] : symbolTable().intern("");
+            break;
+        case InstructionType::DECLARE:
+            op.op = OpCode::DECLARE;
+            op.dst = NO_VARIABLE_SLOT;
+            if (inst.arg_count >= 2) {
+                op.dst = inst.arg_slots[0];
+                op.a = static_cast<uint16_t>(literalArg(inst, 1));
+            }
+            break;
+        case InstructionType::ADD:
+        case InstructionType::SUBTRACT:
+            op.op = inst.type == InstructionType::ADD ? OpCode::ADD : OpCode::SUBTRACT;
+            op.dst = NO_VARIABLE_SLOT;
+            if (inst.arg_count >= 3) {
+                op.dst = inst.arg_slots[0];
+                op.a = operand(inst, 1, OPERAND_A_SLOT, op.flags);
+                op.b = operand(inst, 2, OPERAND_B_SLOT, op.flags);
+            }
+            break;
+        case InstructionType::SLEEP:
+            op.op = OpCode::SLEEP;
+            op.a = literalArg(inst, 0);
+            break;
+        case InstructionType::FOR_START:
+            op.op = OpCode::FOR_START;
+            op.dst = static_cast<uint16_t>(open_loops.size());
+            op.a = inst.for_repeats;
+            open_loops.push_back(OpenLoop{index, static_cast<uint32_t>(inst.for_repeats)});
+            break;
+        case InstructionType::FOR_END:
+            op.op = OpCode::FOR_END;
+            op.a = NO_JUMP_TARGET;
+            if (!open_loops.empty()) {
+                OpenLoop loop = open_loops.back();
+                open_loops.pop_back();
+                op.dst = static_cast<uint16_t>(open_loops.size());
+                op.a = loop.start;
+                op.b = loop.repeats;
+            }
+            break;
+    }
+    
+    code.push_back(op);
+}
+
+void compileInstructions(const std::vector<Instruction>& instructions, Program& program) {
+    ProgramCompiler compiler;
+    program.code.reserve(program.code.size() + instructions.size());
+    
+    for (const Instruction& inst : instructions) {
+        compiler.append(inst, program.code, static_cast<uint32_t>(program.code.size()));
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "instruction.h"
+#include "arena.h"
+
+// Flat bytecode the Process interpreter runs. Each Instruction lowers to
+// exactly one ByteOp, so a program counter indexes both lists.
+enum class OpCode : uint8_t {
+    PRINT,
+    DECLARE,
+    ADD,
+    SUBTRACT,
+    SLEEP,
+    FOR_START,
+    FOR_END
+};
+
+// Operand flags: set when the operand is a variable slot, not an immediate
+const uint8_t OPERAND_A_SLOT = 0x1;
+const uint8_t OPERAND_B_SLOT = 0x2;
+
+const uint32_t NO_JUMP_TARGET = 0xFFFFFFFF;
+
+// Operand layout per opcode:
+//   PRINT      a = message id in symbolTable()
+//   DECLARE    dst = slot (or NO_VARIABLE_SLOT), a = value
+//   ADD/SUB    dst = slot, a/b = immediate or slot (see flags)
+//   SLEEP      a = ticks
+//   FOR_START  dst = nesting depth, a = repeats
+//   FOR_END    dst = nesting depth, a = FOR_START index, b = repeats
+struct ByteOp {
+    OpCode op;
+    uint8_t flags;
+    uint16_t dst;
+    uint32_t a;
+    uint32_t b;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Compiled program of one process. Code lives in the process's arena and
+// is freed when the arena is released; PRINT strings are interned globally
+// so log records can keep referring to them after that.
+struct Program {
+    ArenaVector<ByteOp> code;
+    
+    explicit Program(Arena& arena)
+        : code(ArenaAllocator<ByteOp>(arena)) {}
+    
+    // Drop every reference into the arena before it is released
+    void reset() {
+        ArenaVector<ByteOp>(code.get_allocator()).swap(code);
+    }
+};
+
+inline const char* opcodeName(OpCode op) {
+    switch (op) {
+        case OpCode::PRINT: return "PRINT";
+        case OpCode::DECLARE: return "DECLARE";
+        case OpCode::ADD: return "ADD";
+        case OpCode::SUBTRACT: return "SUBTRACT";
+        case OpCode::SLEEP: return "SLEEP";
+        case OpCode::FOR_START: return "FOR_START";
+        case OpCode::FOR_END: return "FOR_END";
+    }
+    return "UNKNOWN";
+}
+
+// Lowers instructions one at a time, for programs that are generated in
+// chunks. Jump targets are absolute program counters, so they stay valid
+// however much of the program the code window currently holds.
+class ProgramCompiler {
+public:
+    // index is the absolute program counter of the op being appended
+    void append(const Instruction& inst, ArenaVector<ByteOp>& code, uint32_t index);
+    
+private:
+    struct OpenLoop {
+        uint32_t start; // Index of the FOR_START
+        uint32_t repeats;
+    };
+    std::vector<OpenLoop> open_loops; // Unmatched FOR_STARTs, innermost last
+};
+
+// Lower a flat instruction list (FOR_START/FOR_END markers) into bytecode,
+// parsing literals and resolving loop jumps once. Variable slots come from
+// Instruction::arg_slots; a NO_VARIABLE_SLOT destination is a dropped write.
+// Code is allocated from the arena behind program.
+void compileInstructions(const std::vector<Instruction>& instructions, Program& program);
+
+#endif
@@ -2,6 +2,10 @@
 #define CONFIG_H
 
 #include <string>
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <sstream>
 
 // Default configuration for the scheduler
 // This can be loaded from config.txt
@@ -9,15 +13,144 @@ struct Config {
     int num_cpu = 2;
     std::string scheduler = "rr";
     int quantum_cycles = 4;
+    int mlfq_levels = 3; // MLFQ only: number of priority levels
+    std::string mlfq_quantums = ""; // MLFQ only: quantum per level, e.g. 2,4,8; empty doubles quantum_cycles per level
+    int mlfq_boost_ticks = 100; // MLFQ only: ticks between moving everything back to the top level, 0 never
+    int sjf_aging_ticks = 0; // SJF/SRTF only: ticks of waiting worth one instruction less, 0 no aging
     int batch_process_freq = 1;
     int min_ins = 100;
     int max_ins = 100;
     int delays_per_exec = 0;
+    std::string tick_mode = "realtime"; // realtime: 100ms per tick, fast: ticks back-to-back
+    std::string exec_mode = "serial"; // serial: one tick loop, parallel: one thread per core
+    std::string ready_queue = "global"; // global: one shared queue, per-core: work-stealing lanes
+    unsigned long long seed = 0; // Master seed for process generation, 0 picks a random one
+    int generator_threads = 2; // Threads generating process programs in the background
     
     // Memory management parameters
     size_t max_overall_mem = 16384;
     size_t mem_per_frame = 16;
     size_t mem_per_proc = 4096;
+    std::string mem_alloc = "first-fit"; // first-fit, best-fit or worst-fit
+    std::string memory_model = "contiguous"; // contiguous or paging
+    std::string page_replacement = "fifo"; // fifo, lru or clock (paging only)
+    size_t log_capacity = 100; // PRINT records kept in memory per process
+    std::string snapshot_format = "binary"; // binary: memory_stamps.bin, text: memory_stamps.txt
+    std::string trace_mode = "off"; // off, record (write trace_file) or replay (check against it)
+    std::string trace_file = "scheduler_trace.bin";
 };
 
+// Applies one config.txt setting; false for an unknown key
+inline bool setConfigValue(Config& config, const std::string& key, const std::string& value) {
+    if (key == "num-cpu") {
+        config.num_cpu = std::stoi(value);
+    } else if (key == "scheduler") {
+        config.scheduler = value;
+    } else if (key == "quantum-cycles") {
+        config.quantum_cycles = std::stoi(value);
+    } else if (key == "mlfq-levels") {
+        config.mlfq_levels = std::stoi(value);
+    } else if (key == "mlfq-quantums") {
+        config.mlfq_quantums = value;
+    } else if (key == "mlfq-boost-ticks") {
+        config.mlfq_boost_ticks = std::stoi(value);
+    } else if (key == "sjf-aging-ticks") {
+        config.sjf_aging_ticks = std::stoi(value);
+    } else if (key == "batch-process-freq") {
+        config.batch_process_freq = std::stoi(value);
+    } else if (key == "min-ins") {
+        config.min_ins = std::stoi(value);
+    } else if (key == "max-ins") {
+        config.max_ins = std::stoi(value);
+    } else if (key == "delays-per-exec") {
+        config.delays_per_exec = std::stoi(value);
+    } else if (key == "tick-mode") {
+        config.tick_mode = value;
+    } else if (key == "exec-mode") {
+        config.exec_mode = value;
+    } else if (key == "ready-queue") {
+        config.ready_queue = value;
+    } else if (key == "seed") {
+        config.seed = std::stoull(value);
+    } else if (key == "generator-threads") {
+        config.generator_threads = std::stoi(value);
+    } else if (key == "max-overall-mem") {
+        config.max_overall_mem = std::stoi(value);
+    } else if (key == "mem-per-frame") {
+        config.mem_per_frame = std::stoi(value);
+    } else if (key == "mem-per-proc") {
+        config.mem_per_proc = std::stoi(value);
+    } else if (key == "mem-alloc") {
+        config.mem_alloc = value;
+    } else if (key == "memory-model") {
+        config.memory_model = value;
+    } else if (key == "page-replacement") {
+        config.page_replacement = value;
+    } else if (key == "log-capacity") {
+        config.log_capacity = std::stoi(value);
+    } else if (key == "snapshot-format") {
+        config.snapshot_format = value;
+    } else if (key == "trace-mode") {
+        config.trace_mode = value;
+    } else if (key == "trace-file") {
+        config.trace_file = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Reads "key value" lines; unknown keys and malformed lines are skipped
+inline void parseConfig(std::istream& in, Config& config) {
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        std::string key, value;
+        
+        if (iss >> key >> value) {
+            setConfigValue(config, key, value);
+        }
+    }
+}
+
+inline bool loadConfigFile(const std::string& path, Config& config) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    parseConfig(file, config);
+    return true;
+}
+
+// Writes the settings that shape a run in config.txt format; a trace keeps
+// this so it can be replayed with the same settings
+inline void writeConfig(std::ostream& out, const Config& config) {
+    out << "num-cpu " << config.num_cpu << "\n";
+    out << "scheduler " << config.scheduler << "\n";
+    out << "quantum-cycles " << config.quantum_cycles << "\n";
+    out << "mlfq-levels " << config.mlfq_levels << "\n";
+    if (!config.mlfq_quantums.empty()) {
+        out << "mlfq-quantums " << config.mlfq_quantums << "\n";
+    }
+    out << "mlfq-boost-ticks " << config.mlfq_boost_ticks << "\n";
+    out << "sjf-aging-ticks " << config.sjf_aging_ticks << "\n";
+    out << "batch-process-freq " << config.batch_process_freq << "\n";
+    out << "min-ins " << config.min_ins << "\n";
+    out << "max-ins " << config.max_ins << "\n";
+    out << "delays-per-exec " << config.delays_per_exec << "\n";
+    out << "tick-mode " << config.tick_mode << "\n";
+    out << "exec-mode " << config.exec_mode << "\n";
+    out << "ready-queue " << config.ready_queue << "\n";
+    out << "seed " << config.seed << "\n";
+    out << "generator-threads " << config.generator_threads << "\n";
+    out << "max-overall-mem " << config.max_overall_mem << "\n";
+    out << "mem-per-frame " << config.mem_per_frame << "\n";
+    out << "mem-per-proc " << config.mem_per_proc << "\n";
+    out << "mem-alloc " << config.mem_alloc << "\n";
+    out << "memory-model " << config.memory_model << "\n";
+    out << "page-replacement " << config.page_replacement << "\n";
+    out << "log-capacity " << config.log_capacity << "\n";
+    out << "snapshot-format " << config.snapshot_format << "\n";
+}
+
 #endif
\ No newline at end of file
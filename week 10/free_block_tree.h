@@ -0,0 +1,130 @@
+#ifndef FREE_BLOCK_TREE_H
+#define FREE_BLOCK_TREE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+// Free blocks ordered by address (a treap), where every node also knows the
+// largest block in its subtree. That lets first-fit descend straight to the
+// lowest address with a block big enough instead of walking the blocks in
+// address order. Insert, erase and lowestFit are O(log n) expected.
+class FreeBlockTree {
+private:
+    static const int NONE = -1;
+    
+    struct Node {
+        size_t address;
+        size_t size;
+        size_t max_size; // Largest size in this subtree
+        uint32_t priority;
+        int left;
+        int right;
+    };
+    
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes; // Reusable slots in nodes
+    int root = NONE;
+    size_t count = 0;
+    uint32_t random_state = 0x9E3779B9u;
+    
+public:
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    
+    void insert(size_t address, size_t size) {
+        int node = newNode(address, size);
+        int left, right;
+        split(root, address, left, right);
+        root = merge(merge(left, node), right);
+        count++;
+    }
+    
+    void erase(size_t address) {
+        int left, middle, right;
+        split(root, address, left, right);
+        split(right, address + 1, middle, right);
+        if (middle != NONE) {
+            free_nodes.push_back(middle);
+            count--;
+        }
+        root = merge(left, right);
+    }
+    
+    // Lowest address of a block of at least size, false if none is that big
+    bool lowestFit(size_t size, size_t& address) const {
+        int node = root;
+        while (node != NONE && nodes[node].max_size >= size) {
+            const Node& current = nodes[node];
+            if (current.left != NONE && nodes[current.left].max_size >= size) {
+                node = current.left;
+            } else if (current.size >= size) {
+                address = current.address;
+                return true;
+            } else {
+                node = current.right;
+            }
+        }
+        return false;
+    }
+    
+private:
+    int newNode(size_t address, size_t size) {
+        // xorshift32: the priorities only need to look random
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+        Node node = {address, size, size, random_state, NONE, NONE};
+        
+        if (!free_nodes.empty()) {
+            int index = free_nodes.back();
+            free_nodes.pop_back();
+            nodes[index] = node;
+            return index;
+        }
+        nodes.push_back(node);
+        return static_cast<int>(nodes.size() - 1);
+    }
+    
+    size_t maxOf(int node) const {
+        return node == NONE ? 0 : nodes[node].max_size;
+    }
+    
+    void update(int node) {
+        Node& current = nodes[node];
+        current.max_size = std::max(current.size, std::max(maxOf(current.left), maxOf(current.right)));
+    }
+    
+    // Addresses below key go to left, the rest to right
+    void split(int node, size_t key, int& left, int& right) {
+        if (node == NONE) {
+            left = right = NONE;
+            return;
+        }
+        if (nodes[node].address < key) {
+            split(nodes[node].right, key, nodes[node].right, right);
+            left = node;
+        } else {
+            split(nodes[node].left, key, left, nodes[node].left);
+            right = node;
+        }
+        update(node);
+    }
+    
+    // Every address in left is below every address in right
+    int merge(int left, int right) {
+        if (left == NONE) return right;
+        if (right == NONE) return left;
+        if (nodes[left].priority > nodes[right].priority) {
+            nodes[left].right = merge(nodes[left].right, right);
+            update(left);
+            return left;
+        }
+        nodes[right].left = merge(left, nodes[right].left);
+        update(right);
+        return right;
+    }
+};
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef GENERATOR_POOL_H
+#define GENERATOR_POOL_H
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include "process.h"
+#include "lockfree_queue.h"
+
+// Mixes a master seed and a process id into that process's own seed
+// (splitmix64), so every process's program depends only on the two
+inline uint64_t processSeed(uint64_t master_seed, int process_id) {
+    uint64_t z = master_seed + 0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(process_id) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Pool of threads that generate and compile process programs off the
+// scheduler thread. Processes go in and come back out through lock-free
+// queues; take() hands them back in submission order whatever order the
+// workers finish in, so admission stays reproducible.
+class GeneratorPool {
+private:
+    struct Job {
+        uint64_t ticket;
+        Process* process;
+        uint64_t seed;
+    };
+    
+    LockFreeQueue<Job> jobs;
+    LockFreeQueue<Job> done;
+    std::map<uint64_t, Process*> reorder; // Finished early, waiting for their turn
+    std::vector<std::thread> workers;
+    std::atomic<bool> running{false};
+    std::atomic<int> live_workers{0};
+    std::atomic<uint64_t> next_ticket{0};
+    std::atomic<uint64_t> next_to_take{0}; // Advanced by the consumer only
+    int min_ins = 0;
+    int max_ins = 0;
+    
+    // Only used to park idle workers; jobs never pass through it. queued_jobs
+    // counts jobs pushed and not yet claimed, so a wakeup cannot be missed.
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    size_t queued_jobs = 0;
+    
+public:
+    static const uint64_t CAPACITY = 1024;
+    
+    GeneratorPool() : jobs(CAPACITY), done(CAPACITY) {}
+    
+    ~GeneratorPool() {
+        stop();
+        for (auto& entry : reorder) {
+            delete entry.second;
+        }
+        Job job;
+        while (done.tryPop(job)) {
+            delete job.process;
+        }
+        while (jobs.tryPop(job)) {
+            delete job.process;
+        }
+    }
+    
+    void start(int threads, int min_instructions, int max_instructions) {
+        if (running) {
+            return;
+        }
+        min_ins = min_instructions;
+        max_ins = max_instructions;
+        running = true;
+        live_workers = std::max(1, threads);
+        for (int i = 0; i < std::max(1, threads); i++) {
+            workers.emplace_back(&GeneratorPool::workerLoop, this);
+        }
+    }
+    
+    // Workers finish every job already submitted before they exit, so
+    // take() can still collect them
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            running = false;
+        }
+        idle_cv.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        workers.clear();
+    }
+    
+    // Takes ownership of the process until take() returns it with its
+    // program generated. A single producer thread keeps tickets in the
+    // order the processes were created. Waits while CAPACITY processes are
+    // already in flight, which also keeps the done queue from filling up.
+    void submit(std::unique_ptr<Process> process, uint64_t seed) {
+        while (outstanding() >= CAPACITY) {
+            std::this_thread::yield();
+        }
+        Job job = {next_ticket++, process.release(), seed};
+        while (!jobs.tryPush(job)) {
+            std::this_thread::yield();
+        }
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            queued_jobs++;
+        }
+        idle_cv.notify_one();
+    }
+    
+    // Submitted but not taken yet
+    uint64_t outstanding() const {
+        return next_ticket - next_to_take;
+    }
+    
+    // Next process in submission order, or nullptr if it is not ready yet
+    std::unique_ptr<Process> tryTake() {
+        Job job;
+        while (done.tryPop(job)) {
+            reorder[job.ticket] = job.process;
+        }
+        auto it = reorder.find(next_to_take);
+        if (it == reorder.end()) {
+            return nullptr;
+        }
+        std::unique_ptr<Process> process(it->second);
+        reorder.erase(it);
+        next_to_take++;
+        return process;
+    }
+    
+    // Waits for the next process in submission order; nullptr if nothing
+    // is outstanding, or if no worker is left to generate it
+    std::unique_ptr<Process> take() {
+        while (outstanding() > 0) {
+            bool workers_gone = live_workers == 0;
+            std::unique_ptr<Process> process = tryTake();
+            if (process || workers_gone) {
+                return process;
+            }
+            std::this_thread::yield();
+        }
+        return nullptr;
+    }
+    
+private:
+    void workerLoop() {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(idle_mutex);
+                idle_cv.wait(lock, [this] { return queued_jobs > 0 || !running; });
+                if (queued_jobs == 0) {
+                    break;
+                }
+                queued_jobs--;
+            }
+            
+            // Counted only after the push completed, so the job is there
+            Job job;
+            while (!jobs.tryPop(job)) {
+                std::this_thread::yield();
+            }
+            job.process->generateRandomInstructions(min_ins, max_ins, job.seed);
+            while (!done.tryPush(job)) {
+                std::this_thread::yield();
+            }
+        }
+        live_workers--;
+    }
+};
+
+#endif
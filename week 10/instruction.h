@@ -1,8 +1,12 @@
 #ifndef INSTRUCTION_H
 #define INSTRUCTION_H
 
-#include <vector>
-#include <string>
+#include <cstdint>
+
+// Symbol table: at most 32 uint16 variables (64 bytes) per process
+const int MAX_VARIABLES = 32;
+const uint16_t NO_VARIABLE_SLOT = 0xFFFF;
+const uint32_t NO_SYMBOL = 0xFFFFFFFF; // Argument without text, see Instruction
 
 enum class InstructionType {
     PRINT,
@@ -14,11 +18,23 @@ enum class InstructionType {
     FOR_END
 };
 
+// Arguments are ids into symbolTable() (string_table.h): PRINT messages and
+// numeric literals are each stored once for all processes. Variables are
+// resolved to arg_slots at generation, so generated programs pass NO_SYMBOL
+// for them instead of interning a name nothing reads.
 struct Instruction {
     InstructionType type;
-    std::vector<std::string> args;
+    uint8_t arg_count = 0;
+    uint32_t args[3] = {0, 0, 0};
+    // Symbol table slot of each args entry naming a variable, resolved at generation
+    uint16_t arg_slots[3] = {NO_VARIABLE_SLOT, NO_VARIABLE_SLOT, NO_VARIABLE_SLOT};
     int for_repeats = 0;
-    std::vector<Instruction> for_instructions;
+    
+    void addArg(uint32_t symbol) {
+        if (arg_count < 3) {
+            args[arg_count++] = symbol;
+        }
+    }
 };
 
 #endif
\ No newline at end of file
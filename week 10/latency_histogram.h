@@ -0,0 +1,121 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+
+// HDR-style histogram of durations in nanoseconds. Values below 64 get a
+// bucket each; above that every power of two is split into 32 buckets, so
+// any recorded value is known to within about 3% across the whole range
+// using a fixed 1920 counters.
+//
+// One thread records; counters are relaxed atomics written with plain
+// load/store, so recording costs no locked instruction and other threads
+// can read a slightly stale but consistent-enough picture at any time.
+class LatencyHistogram {
+private:
+    static const int SUB_BITS = 5;
+    static const uint64_t SUB_COUNT = 1 << SUB_BITS; // Buckets per power of two
+    static const uint64_t EXACT_LIMIT = SUB_COUNT * 2; // Below this, one bucket per value
+    static const int BUCKETS = static_cast<int>(EXACT_LIMIT + (64 - SUB_BITS - 1) * SUB_COUNT);
+    
+    std::atomic<uint64_t> counts[BUCKETS];
+    std::atomic<uint64_t> total_count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    
+public:
+    LatencyHistogram() {
+        reset();
+    }
+    
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    
+    // Recording thread only
+    void record(uint64_t ns) {
+        bump(counts[bucketOf(ns)], 1);
+        bump(total_count, 1);
+        bump(total_ns, ns);
+        if (ns > max_ns.load(std::memory_order_relaxed)) {
+            max_ns.store(ns, std::memory_order_relaxed);
+        }
+    }
+    
+    // Recording thread only
+    void reset() {
+        for (std::atomic<uint64_t>& count : counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        total_count.store(0, std::memory_order_relaxed);
+        total_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+    }
+    
+    uint64_t count() const { return total_count.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_ns.load(std::memory_order_relaxed); }
+    
+    double mean() const {
+        uint64_t n = count();
+        return n > 0 ? static_cast<double>(total_ns.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+    
+    // Upper bound of the bucket holding the given percentile (0-100)
+    uint64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(p / 100.0 * n + 0.5);
+        target = std::max<uint64_t>(1, std::min(target, n));
+        
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                return std::min(upperBoundOf(i), max());
+            }
+        }
+        return max();
+    }
+    
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    
+    static int highestBit(uint64_t value) {
+        int bit = 0;
+        for (int step = 32; step > 0; step /= 2) {
+            if (value >> step) {
+                value >>= step;
+                bit += step;
+            }
+        }
+        return bit;
+    }
+    
+    // Values with their highest bit at position b (b > SUB_BITS) keep their
+    // top SUB_BITS + 1 bits
+    static int bucketOf(uint64_t ns) {
+        if (ns < EXACT_LIMIT) {
+            return static_cast<int>(ns);
+        }
+        int shift = highestBit(ns) - SUB_BITS;
+        uint64_t mantissa = ns >> shift; // In [SUB_COUNT, 2 * SUB_COUNT)
+        return static_cast<int>(EXACT_LIMIT + (shift - 1) * SUB_COUNT + (mantissa - SUB_COUNT));
+    }
+    
+    static uint64_t upperBoundOf(int bucket) {
+        if (bucket < static_cast<int>(EXACT_LIMIT)) {
+            return static_cast<uint64_t>(bucket);
+        }
+        uint64_t offset = static_cast<uint64_t>(bucket) - EXACT_LIMIT;
+        int shift = static_cast<int>(offset / SUB_COUNT) + 1;
+        uint64_t mantissa = SUB_COUNT + offset % SUB_COUNT;
+        return ((mantissa + 1) << shift) - 1;
+    }
+};
+
+#endif
@@ -32,15 +32,15 @@ private:
     Config config;
     bool initialized = false;
     bool running = true;
-    Process* current_screen_process = nullptr;
+    std::string current_screen_process; // Name of the attached process, empty if none
     
 public:
     void run() {
         printHeader();
         std::cout << "Type 'initialize' to start, or 'exit' to quit.\n\n";
         while (running) {
-            if (current_screen_process) {
-                std::cout << "[" << current_screen_process->name << "] >> ";
+            if (!current_screen_process.empty()) {
+                std::cout << "[" << current_screen_process << "] >> ";
             } else {
                 std::cout << ">> ";
             }
@@ -48,7 +48,7 @@ public:
             std::string input;
             std::getline(std::cin, input);
             
-            if (current_screen_process) {
+            if (!current_screen_process.empty()) {
                 processScreenCommand(input);
             } else {
                 processMainMenuCommand(input);
@@ -87,11 +87,15 @@ private:
             handleSchedulerStop();
         } else if (cmd == "report-util") {
             handleReportUtil();
+        } else if (cmd == "report-perf") {
+            handleReportPerf(tokens.size() > 1 && tokens[1] == "reset");
+        } else if (cmd == "trace-status") {
+            scheduler.printTraceStatus(std::cout);
         } else if (cmd == "debug") {
             debugProcessStates();
         } else {
             std::cout << "Unknown command: " << cmd << "\n";
-            std::cout << "Available commands: initialize, exit, screen, scheduler-start, scheduler-stop, report-util\n";
+            std::cout << "Available commands: initialize, exit, screen, scheduler-start, scheduler-stop, report-util, report-perf [reset], trace-status\n";
         }
     }
 
@@ -103,35 +107,54 @@ private:
         std::string cmd = tokens[0];
         
         if (cmd == "exit") {
-            current_screen_process = nullptr;
+            current_screen_process.clear();
             clearScreen();
             printHeader();
         } else if (cmd == "process-smi") {
-            if (current_screen_process) {
-                std::cout << "\nProcess: " << current_screen_process->name << "\n";
-                std::cout << "ID: " << current_screen_process->id << "\n";
+            ProcessView process;
+            ProcessRecord record;
+            ProcessLog log;
+            
+            if (scheduler.getProcessView(current_screen_process, process, &log)) {
+                std::cout << "\nProcess: " << process.name << "\n";
+                std::cout << "ID: " << process.id << "\n";
                 
-                if (current_screen_process->isFinished()) {
+                if (process.state == ProcessState::FINISHED) {
                     std::cout << "Status: Finished!\n";
                 } else {
-                    std::cout << "Current instruction line: " << current_screen_process->current_instruction + 1 << " / " << current_screen_process->instructions.size() << "\n";
+                    std::cout << "Current instruction line: " << process.current_instruction + 1 << " / " << process.instruction_count << "\n";
                     std::cout << "State: ";
-                    switch (current_screen_process->state) {
+                    switch (process.state) {
                         case ProcessState::READY: std::cout << "Ready\n"; break;
                         case ProcessState::RUNNING: std::cout << "Running\n"; break;
                         case ProcessState::WAITING: std::cout << "Waiting\n"; break;
                         case ProcessState::FINISHED: std::cout << "Finished\n"; break;
                     }
                 }
-                
-                std::cout << "\nLogs:\n";
-                for (const auto& log : current_screen_process->output_logs) {
-                    std::cout << log << "\n";
-                }
+            } else if (scheduler.getFinishedProcess(current_screen_process, record)) {
+                // Process has been retired; show it from the archive
+                std::cout << "\nProcess: " << record.name << "\n";
+                std::cout << "ID: " << record.id << "\n";
+                std::cout << "Status: Finished!\n";
+                log = *record.log;
+            }
+            
+            // Newest page by default; process-smi <page> goes further back
+            const size_t page_size = 20;
+            size_t pages = std::max<size_t>(1, (log.size() + page_size - 1) / page_size);
+            size_t page = pages;
+            size_t requested = 0;
+            if (tokens.size() >= 2 && (std::istringstream(tokens[1]) >> requested) && requested > 0) {
+                page = std::min(pages, requested);
+            }
+            
+            std::cout << "\nLogs (page " << page << "/" << pages << ", " << log.size() << " lines):\n";
+            for (const auto& line : log.lines((page - 1) * page_size, page_size)) {
+                std::cout << line << "\n";
             }
         } else {
             std::cout << "Unknown command in process screen: " << cmd << "\n";
-            std::cout << "Available commands: process-smi, exit\n";
+            std::cout << "Available commands: process-smi [page], exit\n";
         }
     }
 
@@ -148,20 +171,60 @@ private:
                 std::cout << " (Round Robin)";
             } else if (config.scheduler == "fcfs") {
                 std::cout << " (First Come First Serve)";
+            } else if (config.scheduler == "mlfq") {
+                std::cout << " (Multi-Level Feedback Queue)";
+            } else if (config.scheduler == "sjf") {
+                std::cout << " (Shortest Job First)";
+            } else if (config.scheduler == "srtf") {
+                std::cout << " (Shortest Remaining Time First)";
             }
             std::cout << "\n";
             if (config.scheduler == "rr") {
                 std::cout << "Quantum cycles: " << config.quantum_cycles << "\n";
+            } else if (config.scheduler == "mlfq") {
+                std::cout << "Level quantums:";
+                for (int quantum : scheduler.getLevelQuantums()) {
+                    std::cout << " " << quantum;
+                }
+                std::cout << "\n";
+                if (config.mlfq_boost_ticks > 0) {
+                    std::cout << "Priority boost: every " << config.mlfq_boost_ticks << " ticks\n";
+                } else {
+                    std::cout << "Priority boost: off\n";
+                }
+            } else if (config.scheduler == "sjf" || config.scheduler == "srtf") {
+                if (config.sjf_aging_ticks > 0) {
+                    std::cout << "Aging: one instruction per " << config.sjf_aging_ticks << " ticks waited\n";
+                } else {
+                    std::cout << "Aging: off\n";
+                }
             }
             std::cout << "Process generation frequency: " << config.batch_process_freq << " ticks\n";
             std::cout << "Instructions per process: " << config.min_ins << "-" << config.max_ins << "\n";
+            std::cout << "Tick mode: " << config.tick_mode << "\n";
+            std::cout << "Execution mode: " << config.exec_mode;
+            if (config.exec_mode == "parallel") {
+                std::cout << " (one thread per core)";
+            }
+            std::cout << "\n";
+            std::cout << "Ready queue: " << config.ready_queue << "\n";
+            std::cout << "Generator threads: " << config.generator_threads << "\n";
+            std::cout << "Seed: " << scheduler.getMasterSeed() << "\n";
             
             // Display memory configuration
             std::cout << "\nMemory Configuration:\n";
             std::cout << "Total memory: " << config.max_overall_mem << " KB\n";
             std::cout << "Memory per frame: " << config.mem_per_frame << " KB\n";
             std::cout << "Memory per process: " << config.mem_per_proc << " KB\n";
-            std::cout << "Maximum processes in memory: " << (config.max_overall_mem / config.mem_per_proc) << "\n";
+            if (config.memory_model == "paging") {
+                std::cout << "Memory model: demand paging (" << config.page_replacement << " replacement)\n";
+                std::cout << "Frames: " << (config.max_overall_mem / config.mem_per_frame) << "\n";
+            } else {
+                std::cout << "Allocation policy: " << config.mem_alloc << "\n";
+                std::cout << "Maximum processes in memory: " << (config.max_overall_mem / config.mem_per_proc) << "\n";
+            }
+            std::cout << "Snapshot format: " << config.snapshot_format << "\n";
+            scheduler.printTraceStatus(std::cout);
         } else {
             std::cout << "Failed to load configuration. Using default values.\n";
             scheduler.initialize(config);
@@ -178,17 +241,19 @@ private:
             return;
         }
         
-        if (tokens[0] == "-s" && tokens.size() >= 2) {
+        if (tokens[0] == "-s" && tokens.size() >= 2 && scheduler.isReplaying()) {
+            std::cout << "Cannot create processes while replaying a trace.\n";
+        } else if (tokens[0] == "-s" && tokens.size() >= 2) {
             std::string process_name = tokens[1];
-            Process* process = scheduler.createProcess(process_name);
-            current_screen_process = process;
+            scheduler.createProcess(process_name);
+            current_screen_process = process_name;
             clearScreen();
             std::cout << "Created and attached to process: " << process_name << "\n";
         } else if (tokens[0] == "-r" && tokens.size() >= 2) {
             std::string process_name = tokens[1];
-            Process* process = scheduler.findProcess(process_name);
-            if (process && !process->isFinished()) {
-                current_screen_process = process;
+            ProcessView process;
+            if (scheduler.getProcessView(process_name, process) && process.state != ProcessState::FINISHED) {
+                current_screen_process = process_name;
                 clearScreen();
                 std::cout << "Attached to process: " << process_name << "\n";
             } else {
@@ -202,6 +267,10 @@ private:
     }
 
     void handleSchedulerStart() {
+        if (scheduler.isReplaying()) {
+            std::cout << "Replaying a trace; processes come from the recording.\n";
+            return;
+        }
         scheduler.startProcessGeneration();
         std::cout << "Scheduler started. Generating processes...\n";
     }
@@ -212,52 +281,91 @@ private:
     }
 
     void handleReportUtil() {
+        auto stats = scheduler.getStats();
+        
         std::cout << "\nCPU Utilization Report\n";
         std::cout << "======================\n";
-        std::cout << "CPU utilization: " << std::fixed << std::setprecision(2) << scheduler.getCPUUtilization() << "%\n";
-        std::cout << "Cores used: " << scheduler.getUsedCores() << "\n";
-        std::cout << "Cores available: " << scheduler.getAvailableCores() << "\n";
-        std::cout << "Current CPU ticks: " << scheduler.getCurrentTicks() << "\n";
+        std::cout << "CPU utilization: " << std::fixed << std::setprecision(2) << stats->cpuUtilization() << "%\n";
+        std::cout << "Cores used: " << stats->used_cores << "\n";
+        std::cout << "Cores available: " << stats->availableCores() << "\n";
+        std::cout << "Current CPU ticks: " << stats->tick << "\n";
         
         // Add memory utilization information
         std::cout << "\nMemory Utilization\n";
         std::cout << "==================\n";
         std::cout << "Processes in memory: " << scheduler.getProcessesInMemory() << "\n";
         std::cout << "Total external fragmentation: " << scheduler.getTotalExternalFragmentation() << " KB\n";
+        scheduler.printMemoryStats(std::cout);
         
-        auto running_processes = scheduler.getRunningProcesses();
-        auto finished_processes = scheduler.getFinishedProcesses();
+        printArenaStats(std::cout);
         
-        std::cout << "\nRunning processes: " << running_processes.size() << "\n";
-        for (const auto& process : running_processes) {
-            std::cout << "  " << process->name << " (ID: " << process->id << ")\n";
-        }
+        std::cout << "\nRunning processes: " << stats->processCount() << "\n";
+        stats->forEachProcess([](const ProcessView& process) {
+            std::cout << "  " << process.name << " (ID: " << process.id << ")\n";
+        });
         
-        std::cout << "\nFinished processes: " << finished_processes.size() << "\n";
-        for (const auto& process : finished_processes) {
-            std::cout << "  " << process->name << " (ID: " << process->id << ")\n";
-        }
+        std::cout << "\nFinished processes: " << stats->finished_count << "\n";
+        stats->forEachFinished([](const ProcessRecord& process) {
+            std::cout << "  " << process.name << " (ID: " << process.id << ")\n";
+        });
         
-        saveReport();
+        saveReport(*stats);
         std::cout << "\nReport saved to report-util.txt\n";
     }
 
+    // Where tick time goes: latency of each tick phase since start or the
+    // last reset
+    void handleReportPerf(bool reset) {
+        const TickProfiler& profiler = scheduler.getProfiler();
+        
+        std::cout << "\nTick Phase Latency Report\n";
+        std::cout << "=========================\n";
+        std::cout << "Current CPU ticks: " << scheduler.getCurrentTicks() << "\n\n";
+        profiler.print(std::cout);
+        
+        std::ofstream file("perf-report.txt");
+        auto now = std::chrono::system_clock::now();
+        auto time_t = std::chrono::system_clock::to_time_t(now);
+        file << "Tick Phase Latency Report\n";
+        file << "Generated at: " << std::ctime(&time_t);
+        file << "==============================\n\n";
+        file << "Current CPU ticks: " << scheduler.getCurrentTicks() << "\n\n";
+        profiler.print(file);
+        file.close();
+        std::cout << "\nReport saved to perf-report.txt\n";
+        
+        if (reset) {
+            scheduler.resetProfiler();
+            std::cout << "Phase timers reset.\n";
+        }
+    }
+    
+    void printArenaStats(std::ostream& out) {
+        const ArenaStats& stats = arenaStats();
+        out << "\nProgram Arenas\n";
+        out << "==============\n";
+        out << "Live arenas: " << stats.arenas_live << "\n";
+        out << "Chunks allocated / released: " << stats.chunks_allocated << " / " << stats.chunks_released << "\n";
+        out << "Bytes reserved: " << stats.bytes_reserved << "\n";
+        out << "Bytes in use: " << stats.bytes_used << "\n";
+        out << "Allocations served: " << stats.allocations << "\n";
+    }
+    
     void handleScreenList() {
-        std::cout << "\nCPU utilization: " << std::fixed << std::setprecision(2) << scheduler.getCPUUtilization() << "%\n";
-        std::cout << "Cores used: " << scheduler.getUsedCores() << "\n";
-        std::cout << "Cores available: " << scheduler.getAvailableCores() << "\n";
+        auto stats = scheduler.getStats();
+        
+        std::cout << "\nCPU utilization: " << std::fixed << std::setprecision(2) << stats->cpuUtilization() << "%\n";
+        std::cout << "Cores used: " << stats->used_cores << "\n";
+        std::cout << "Cores available: " << stats->availableCores() << "\n";
         
         // Add memory information
         std::cout << "Processes in memory: " << scheduler.getProcessesInMemory() << "\n";
         std::cout << "External fragmentation: " << scheduler.getTotalExternalFragmentation() << " KB\n\n";
         
-        auto running_processes = scheduler.getRunningProcesses();
-        auto finished_processes = scheduler.getFinishedProcesses();
-        
         std::cout << "Running processes:\n";
-        for (const auto& process : running_processes) {
+        stats->forEachProcess([](const ProcessView& process) {
             // Show ALL processes that are not finished (RUNNING, READY, or WAITING)
-            if (process->state != ProcessState::FINISHED) {
+            if (process.state != ProcessState::FINISHED) {
                 // Get current timestamp
                 auto now = std::chrono::system_clock::now();
                 auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -267,21 +375,21 @@ private:
                 timestamp << std::put_time(tm_ptr, "%m/%d/%Y, %I:%M:%S%p");
                 
                 // Show core assignment or status
-                std::cout << process->name 
+                std::cout << process.name 
                         << " (" << timestamp.str() << ") ";
                 
-                if (process->cpu_core_assigned >= 0) {
-                    std::cout << "Core: " << process->cpu_core_assigned;
+                if (process.cpu_core_assigned >= 0) {
+                    std::cout << "Core: " << process.cpu_core_assigned;
                 } else {
                     std::cout << "Core: Not assigned";
                 }
                 
-                std::cout << " " << process->current_instruction << "/" << process->instructions.size() << "\n";
+                std::cout << " " << process.current_instruction << "/" << process.instruction_count << "\n";
             }
-        }
+        });
     
         std::cout << "\nFinished processes:\n";
-        for (const auto& process : finished_processes) {
+        stats->forEachFinished([](const ProcessRecord& process) {
             // Get current timestamp for finished processes
             auto now = std::chrono::system_clock::now();
             auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -290,48 +398,41 @@ private:
             std::ostringstream timestamp;
             timestamp << std::put_time(tm_ptr, "%m/%d/%Y, %I:%M:%S%p");
             
-            std::cout << process->name 
+            std::cout << process.name 
                     << " (" << timestamp.str() << ") "
-                    << "Finished " << process->instructions.size() << "/" << process->instructions.size()
+                    << "Finished " << process.instruction_count << "/" << process.instruction_count
                     << "\n";
-        }
+        });
     }
 
     void debugProcessStates() {
-        auto running_processes = scheduler.getRunningProcesses();
+        auto stats = scheduler.getStats();
         
         std::cout << "\n=== DEBUG: Process States ===\n";
         std::cout << "Processes in memory: " << scheduler.getProcessesInMemory() << "\n";
         std::cout << "External fragmentation: " << scheduler.getTotalExternalFragmentation() << " KB\n\n";
         
-        for (const auto& process : running_processes) {
-            std::cout << process->name << " - State: ";
-            switch (process->state) {
+        stats->forEachProcess([&stats](const ProcessView& process) {
+            std::cout << process.name << " - State: ";
+            switch (process.state) {
                 case ProcessState::READY: std::cout << "READY"; break;
                 case ProcessState::RUNNING: std::cout << "RUNNING"; break;
                 case ProcessState::WAITING: std::cout << "WAITING"; break;
                 case ProcessState::FINISHED: std::cout << "FINISHED"; break;
             }
-            std::cout << " - Core: " << process->cpu_core_assigned;
-            std::cout << " - Instruction: " << process->current_instruction + 1 << "/" << process->instructions.size();
-            std::cout << " - Sleep ticks: " << process->sleep_ticks_remaining;
+            std::cout << " - Core: " << process.cpu_core_assigned;
+            std::cout << " - Instruction: " << process.current_instruction + 1 << "/" << process.instruction_count;
+            std::cout << " - Sleep ticks: " << process.sleepTicksRemaining(stats->tick);
             
             // Show current instruction type
-            if (process->current_instruction < process->instructions.size()) {
-                auto& inst = process->instructions[process->current_instruction];
-                std::cout << " - Current inst: ";
-                switch (inst.type) {
-                    case InstructionType::PRINT: std::cout << "PRINT"; break;
-                    case InstructionType::DECLARE: std::cout << "DECLARE"; break;
-                    case InstructionType::ADD: std::cout << "ADD"; break;
-                    case InstructionType::SUBTRACT: std::cout << "SUBTRACT"; break;
-                    case InstructionType::SLEEP: std::cout << "SLEEP(" << inst.args[0] << ")"; break;
-                    case InstructionType::FOR_START: std::cout << "FOR_START"; break;
-                    case InstructionType::FOR_END: std::cout << "FOR_END"; break;
+            if (process.has_current_op) {
+                std::cout << " - Current inst: " << opcodeName(process.current_op);
+                if (process.current_op == OpCode::SLEEP) {
+                    std::cout << "(" << process.current_operand << ")";
                 }
             }
             std::cout << "\n";
-        }
+        });
         std::cout << "==============================\n\n";
     }
 
@@ -350,46 +451,24 @@ private:
     }
 
     bool loadConfig() {
-        std::ifstream file("config.txt");
-        if (!file.is_open()) {
+        if (!loadConfigFile("config.txt", config)) {
             return false;
         }
         
-        std::string line;
-        while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string key, value;
-            
-            if (iss >> key >> value) {
-                if (key == "num-cpu") {
-                    config.num_cpu = std::stoi(value);
-                } else if (key == "scheduler") {
-                    config.scheduler = value;
-                } else if (key == "quantum-cycles") {
-                    config.quantum_cycles = std::stoi(value);
-                } else if (key == "batch-process-freq") {
-                    config.batch_process_freq = std::stoi(value);
-                } else if (key == "min-ins") {
-                    config.min_ins = std::stoi(value);
-                } else if (key == "max-ins") {
-                    config.max_ins = std::stoi(value);
-                } else if (key == "delays-per-exec") {
-                    config.delays_per_exec = std::stoi(value);
-                } else if (key == "max-overall-mem") {
-                    config.max_overall_mem = std::stoi(value);
-                } else if (key == "mem-per-frame") {
-                    config.mem_per_frame = std::stoi(value);
-                } else if (key == "mem-per-proc") {
-                    config.mem_per_proc = std::stoi(value);
-                }
+        // A replay runs with the settings and seed the trace was recorded with
+        if (config.trace_mode == "replay") {
+            uint64_t seed;
+            std::string recorded;
+            if (SchedulerTrace::readHeader(config.trace_file, seed, recorded)) {
+                std::istringstream recorded_config(recorded);
+                parseConfig(recorded_config, config);
+                config.seed = seed;
             }
         }
-        
-        file.close();
         return true;
     }
 
-    void saveReport() {
+    void saveReport(const SchedulerStats& stats) {
         std::ofstream file("report-util.txt");
         
         auto now = std::chrono::system_clock::now();
@@ -399,28 +478,29 @@ private:
         file << "Generated at: " << std::ctime(&time_t);
         file << "==============================\n\n";
         
-        file << "CPU utilization: " << std::fixed << std::setprecision(2) << scheduler.getCPUUtilization() << "%\n";
-        file << "Cores used: " << scheduler.getUsedCores() << "\n";
-        file << "Cores available: " << scheduler.getAvailableCores() << "\n";
-        file << "Current CPU ticks: " << scheduler.getCurrentTicks() << "\n\n";
+        file << "CPU utilization: " << std::fixed << std::setprecision(2) << stats.cpuUtilization() << "%\n";
+        file << "Cores used: " << stats.used_cores << "\n";
+        file << "Cores available: " << stats.availableCores() << "\n";
+        file << "Current CPU ticks: " << stats.tick << "\n\n";
         
         // Add memory information to report
         file << "Memory Utilization:\n";
         file << "Processes in memory: " << scheduler.getProcessesInMemory() << "\n";
-        file << "Total external fragmentation: " << scheduler.getTotalExternalFragmentation() << " KB\n\n";
+        file << "Total external fragmentation: " << scheduler.getTotalExternalFragmentation() << " KB\n";
+        scheduler.printMemoryStats(file);
         
-        auto running_processes = scheduler.getRunningProcesses();
-        auto finished_processes = scheduler.getFinishedProcesses();
+        printArenaStats(file);
+        file << "\n";
         
-        file << "Running processes: " << running_processes.size() << "\n";
-        for (const auto& process : running_processes) {
-            file << "  " << process->name << " (ID: " << process->id << ")\n";
-        }
+        file << "Running processes: " << stats.processCount() << "\n";
+        stats.forEachProcess([&file](const ProcessView& process) {
+            file << "  " << process.name << " (ID: " << process.id << ")\n";
+        });
         
-        file << "\nFinished processes: " << finished_processes.size() << "\n";
-        for (const auto& process : finished_processes) {
-            file << "  " << process->name << " (ID: " << process->id << ")\n";
-        }
+        file << "\nFinished processes: " << stats.finished_count << "\n";
+        stats.forEachFinished([&file](const ProcessRecord& process) {
+            file << "  " << process.name << " (ID: " << process.id << ")\n";
+        });
         
         file.close();
     }
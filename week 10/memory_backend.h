@@ -0,0 +1,33 @@
+#ifndef MEMORY_BACKEND_H
+#define MEMORY_BACKEND_H
+
+#include <ostream>
+#include <string>
+#include "process.h"
+#include "memory_snapshot.h"
+
+// What the scheduler needs from a memory model: admission, release,
+// occupancy figures and per-quantum snapshots. MemoryManager implements it
+// with contiguous blocks, PagedMemoryManager with demand paging.
+class MemoryBackend {
+public:
+    virtual ~MemoryBackend() {}
+    
+    virtual bool allocateMemory(Process* process) = 0;
+    virtual void deallocateMemory(Process* process) = 0;
+    virtual bool hasAvailableMemory() const = 0;
+    virtual int getProcessesInMemory() const = 0;
+    virtual size_t getTotalExternalFragmentation() const = 0;
+    
+    // Copy of the current layout for the snapshot writer; cheap enough to
+    // take on the scheduler thread every quantum
+    virtual MemorySnapshot captureSnapshot(long long tick) = 0;
+    
+    // Handler processes must route variable accesses through, if any
+    virtual MemoryAccessHandler* accessHandler() { return nullptr; }
+    
+    // Extra backend-specific lines for report-util
+    virtual void printStats(std::ostream&) const {}
+};
+
+#endif
@@ -4,12 +4,17 @@
 #include <vector>
 #include <memory>
 #include <string>
-#include <fstream>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <iterator>
+#include <atomic>
+#include <ostream>
 #include "process.h"
+#include "memory_backend.h"
+#include "free_block_tree.h"
 
 struct MemoryBlock {
     size_t start_address;
@@ -21,207 +26,298 @@ struct MemoryBlock {
         : start_address(start), size(sz), is_free(free), process(proc) {}
 };
 
-class MemoryManager {
+enum class AllocationPolicy {
+    FIRST_FIT,
+    BEST_FIT,
+    WORST_FIT
+};
+
+inline AllocationPolicy parseAllocationPolicy(const std::string& name) {
+    if (name == "best-fit") return AllocationPolicy::BEST_FIT;
+    if (name == "worst-fit") return AllocationPolicy::WORST_FIT;
+    return AllocationPolicy::FIRST_FIT;
+}
+
+// Blocks are kept in an address-ordered tree, and free blocks are also
+// indexed in size-segregated bins (bin k holds sizes in [2^k, 2^(k+1))),
+// both by size and by address. Each bin's address index tracks the largest
+// block under every node, so first-fit finds the lowest fitting address in
+// its own bin without a scan. Allocation, free and coalescing are O(log n)
+// tree operations.
+// Occupancy and fragmentation are kept as running counters, updated on
+// every allocate/free, so monitoring reads are O(1) and lock-free.
+class MemoryManager : public MemoryBackend {
 private:
+    static const int SIZE_BINS = 64;
+    
     size_t total_memory;
     size_t memory_per_frame;
     size_t memory_per_process;
-    std::vector<MemoryBlock> memory_blocks;
+    AllocationPolicy allocation_policy;
+    std::map<size_t, MemoryBlock> memory_blocks; // Every block, by start address
+    std::set<std::pair<size_t, size_t>> free_by_size[SIZE_BINS]; // (size, address)
+    FreeBlockTree free_by_address[SIZE_BINS];
+    std::unordered_map<Process*, size_t> process_blocks; // Process -> block address
     int quantum_cycle_counter;
     
+    // Running counters, written by the scheduler thread only
+    std::atomic<int> used_blocks{0};
+    std::atomic<size_t> free_block_count{0};
+    std::atomic<size_t> total_free{0};
+    std::atomic<size_t> small_free{0}; // Free blocks too small for a process
+    std::atomic<size_t> largest_free{0};
+    std::atomic<size_t> external_fragmentation{0};
+    std::atomic<size_t> free_histogram[SIZE_BINS]; // Free block count per size bin
+    
 public:
-    MemoryManager(size_t total_mem, size_t mem_per_frame, size_t mem_per_proc) 
+    MemoryManager(size_t total_mem, size_t mem_per_frame, size_t mem_per_proc,
+                  AllocationPolicy policy = AllocationPolicy::FIRST_FIT) 
         : total_memory(total_mem), memory_per_frame(mem_per_frame), 
-          memory_per_process(mem_per_proc), quantum_cycle_counter(0) {
+          memory_per_process(mem_per_proc), allocation_policy(policy),
+          quantum_cycle_counter(0) {
+        for (std::atomic<size_t>& count : free_histogram) {
+            count.store(0);
+        }
         
         // Initialize with one large free block
-        memory_blocks.emplace_back(0, total_memory, true, nullptr);
+        addFreeBlock(0, total_memory);
+        publishCounters();
     }
     
-    // First-fit allocation
-    bool allocateMemory(Process* process) {
-        for (auto& block : memory_blocks) {
-            if (block.is_free && block.size >= memory_per_process) {
-                // Found a suitable block
-                if (block.size > memory_per_process) {
-                    // Split the block
-                    size_t remaining_size = block.size - memory_per_process;
-                    memory_blocks.emplace_back(
-                        block.start_address + memory_per_process,
-                        remaining_size,
-                        true,
-                        nullptr
-                    );
-                }
-                
-                // Allocate the block
-                block.size = memory_per_process;
-                block.is_free = false;
-                block.process = process;
-                
-                return true;
-            }
+    bool allocateMemory(Process* process) override {
+        if (process_blocks.count(process)) {
+            return true; // Already resident
         }
-        return false; // No suitable block found
+        
+        size_t address;
+        if (!findFreeBlock(memory_per_process, address)) {
+            return false; // No suitable block found
+        }
+        
+        MemoryBlock& block = memory_blocks.at(address);
+        size_t block_size = block.size;
+        unindexFreeBlock(block);
+        
+        // Split the block, keeping the front for the process
+        if (block_size > memory_per_process) {
+            block.size = memory_per_process;
+            addFreeBlock(address + memory_per_process, block_size - memory_per_process);
+        }
+        
+        block.is_free = false;
+        block.process = process;
+        process_blocks[process] = address;
+        used_blocks.fetch_add(1, std::memory_order_relaxed);
+        publishCounters();
+        return true;
     }
     
     // Deallocate memory when process finishes
-    void deallocateMemory(Process* process) {
-        for (auto& block : memory_blocks) {
-            if (!block.is_free && block.process == process) {
-                block.is_free = true;
-                block.process = nullptr;
-                break;
+    void deallocateMemory(Process* process) override {
+        auto owner = process_blocks.find(process);
+        if (owner == process_blocks.end()) {
+            return;
+        }
+        
+        auto it = memory_blocks.find(owner->second);
+        process_blocks.erase(owner);
+        
+        size_t start = it->second.start_address;
+        size_t size = it->second.size;
+        
+        // Coalesce with the free neighbours on either side
+        if (it != memory_blocks.begin()) {
+            auto prev = std::prev(it);
+            if (prev->second.is_free) {
+                unindexFreeBlock(prev->second);
+                start = prev->second.start_address;
+                size += prev->second.size;
+                memory_blocks.erase(prev);
             }
         }
         
-        // Merge adjacent free blocks
-        mergeAdjacentBlocks();
+        auto next = std::next(it);
+        if (next != memory_blocks.end() && next->second.is_free) {
+            unindexFreeBlock(next->second);
+            size += next->second.size;
+            memory_blocks.erase(next);
+        }
+        
+        memory_blocks.erase(it);
+        addFreeBlock(start, size);
+        used_blocks.fetch_sub(1, std::memory_order_relaxed);
+        publishCounters();
     }
     
     // Check if memory is available
-    bool hasAvailableMemory() const {
-        for (const auto& block : memory_blocks) {
-            if (block.is_free && block.size >= memory_per_process) {
-                return true;
-            }
-        }
-        return false;
+    bool hasAvailableMemory() const override {
+        return largest_free.load(std::memory_order_relaxed) >= memory_per_process;
     }
     
     // Get number of processes in memory
-    int getProcessesInMemory() const {
-        int count = 0;
-        for (const auto& block : memory_blocks) {
-            if (!block.is_free) {
-                count++;
-            }
-        }
-        return count;
+    int getProcessesInMemory() const override {
+        return used_blocks.load(std::memory_order_relaxed);
     }
     
-    // Get total external fragmentation - FIXED VERSION
-    size_t getTotalExternalFragmentation() const {
-        size_t total_fragmentation = 0;
-        int free_block_count = 0;
-        
-        for (const auto& block : memory_blocks) {
-            if (block.is_free) {
-                free_block_count++;
-                // Only count blocks that are smaller than what's needed for a process
-                if (block.size < memory_per_process) {
-                    total_fragmentation += block.size;
-                }
-            }
-        }
-        
-        // Alternative calculation: sum of all free blocks except the largest one
-        // This gives a better representation of unusable fragmented memory
-        if (free_block_count > 1) {
-            std::vector<size_t> free_sizes;
-            for (const auto& block : memory_blocks) {
-                if (block.is_free) {
-                    free_sizes.push_back(block.size);
-                }
-            }
-            
-            if (!free_sizes.empty()) {
-                // Sort to find the largest free block
-                std::sort(free_sizes.begin(), free_sizes.end(), std::greater<size_t>());
-                
-                // Sum all free blocks except the largest one
-                size_t fragmentation_alt = 0;
-                for (size_t i = 1; i < free_sizes.size(); i++) {
-                    fragmentation_alt += free_sizes[i];
-                }
-                
-                // Return the maximum of both calculations
-                return std::max(total_fragmentation, fragmentation_alt);
+    // The larger of the free memory in blocks too small for a process and
+    // all free memory outside the largest block
+    size_t getTotalExternalFragmentation() const override {
+        return external_fragmentation.load(std::memory_order_relaxed);
+    }
+    
+    void printStats(std::ostream& out) const override {
+        out << "Free memory: " << total_free.load(std::memory_order_relaxed) << " KB in "
+            << free_block_count.load(std::memory_order_relaxed) << " blocks (largest "
+            << largest_free.load(std::memory_order_relaxed) << " KB)\n";
+        out << "Free blocks by size:";
+        bool any = false;
+        for (int bin = 0; bin < SIZE_BINS; bin++) {
+            size_t count = free_histogram[bin].load(std::memory_order_relaxed);
+            if (count > 0) {
+                out << " [" << (size_t(1) << bin) << "+ KB] " << count;
+                any = true;
             }
         }
-        
-        return total_fragmentation;
+        out << (any ? "\n" : " none\n");
     }
 
-    // Generate memory snapshot file
-    void generateMemorySnapshot() {
+    MemorySnapshot captureSnapshot(long long tick) override {
         quantum_cycle_counter++;
         
-        // get current timestamp
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm* tm_ptr = std::localtime(&time_t);
-        
-        std::ostringstream timestamp;
-        timestamp << std::put_time(tm_ptr, "%m/%d/%Y %H:%M:%S");
-        
-        // create filename
-        std::string filename = "memory_stamp_" + std::to_string(quantum_cycle_counter) + ".txt";
+        MemorySnapshot snapshot;
+        snapshot.sequence = quantum_cycle_counter;
+        snapshot.tick = tick;
+        snapshot.taken_at = std::chrono::system_clock::now();
+        snapshot.processes_in_memory = getProcessesInMemory();
+        snapshot.external_fragmentation = getTotalExternalFragmentation();
+        snapshot.total_memory = total_memory;
+        snapshot.page_faults = -1;
+        snapshot.regions.reserve(memory_blocks.size());
         
-        std::ofstream file(filename);
-        if (!file.is_open()) {
+        // Memory blocks from top to bottom (highest address first)
+        for (auto it = memory_blocks.rbegin(); it != memory_blocks.rend(); ++it) {
+            const MemoryBlock& block = it->second;
+            SnapshotRegion region;
+            region.upper = block.start_address + block.size;
+            region.lower = block.start_address;
+            region.is_free = block.is_free;
+            region.process_id = block.is_free ? -1 : block.process->id;
+            if (!block.is_free) {
+                region.label = block.process->name;
+            }
+            snapshot.regions.push_back(std::move(region));
+        }
+        return snapshot;
+    }
+    
+private:
+    static int sizeBin(size_t size) {
+        int bin = 0;
+        while (size > 1 && bin < SIZE_BINS - 1) {
+            size >>= 1;
+            bin++;
+        }
+        return bin;
+    }
+    
+    void addFreeBlock(size_t start, size_t size) {
+        if (size == 0) {
             return;
         }
-        
-        // header
-        file << "Timestamp: (" << timestamp.str() << ")\n";
-        file << "Number of processes in memory: " << getProcessesInMemory() << "\n";
-        file << "Total external fragmentation in KB: " << getTotalExternalFragmentation() << "\n";
-        file << "\n";
-        
-        // Write memory layout with upper and lower limits for each process
-        file << "----end---- = " << total_memory << "\n";
-        
-        // Sort blocks by start address for proper display (highest address first)
-        std::vector<MemoryBlock> sorted_blocks = memory_blocks;
-        std::sort(sorted_blocks.begin(), sorted_blocks.end(), 
-                [](const MemoryBlock& a, const MemoryBlock& b) {
-                    return a.start_address > b.start_address; // Sort in descending order
-                });
-        
-        // Write memory blocks from top to bottom
-        for (const auto& block : sorted_blocks) {
-            if (block.is_free) {
-                // Free block - just show the address range
-                file << block.start_address + block.size << "\n";
-                if (block.start_address > 0) {
-                    file << "\n"; // Empty line for free space
-                }
-                file << block.start_address << "\n";
-            } else {
-                // Allocated block - show process name and its limits
-                size_t upper_limit = block.start_address + block.size;
-                size_t lower_limit = block.start_address;
-                
-                file << upper_limit << "\n";
-                file << block.process->name << "\n";
-                file << lower_limit << "\n";
+        memory_blocks.emplace(start, MemoryBlock(start, size, true, nullptr));
+        int bin = sizeBin(size);
+        free_by_size[bin].insert(std::make_pair(size, start));
+        free_by_address[bin].insert(start, size);
+        countFreeBlock(size, 1);
+    }
+    
+    void unindexFreeBlock(const MemoryBlock& block) {
+        int bin = sizeBin(block.size);
+        free_by_size[bin].erase(std::make_pair(block.size, block.start_address));
+        free_by_address[bin].erase(block.start_address);
+        countFreeBlock(block.size, -1);
+    }
+    
+    // Add (direction 1) or remove (direction -1) a free block from the counters
+    void countFreeBlock(size_t size, int direction) {
+        std::memory_order relaxed = std::memory_order_relaxed;
+        if (direction > 0) {
+            free_block_count.fetch_add(1, relaxed);
+            total_free.fetch_add(size, relaxed);
+            free_histogram[sizeBin(size)].fetch_add(1, relaxed);
+            if (size < memory_per_process) {
+                small_free.fetch_add(size, relaxed);
+            }
+        } else {
+            free_block_count.fetch_sub(1, relaxed);
+            total_free.fetch_sub(size, relaxed);
+            free_histogram[sizeBin(size)].fetch_sub(1, relaxed);
+            if (size < memory_per_process) {
+                small_free.fetch_sub(size, relaxed);
             }
         }
-        
-        file << "----start---- = 0\n";
-        file.close();
     }
     
-private:
-    void mergeAdjacentBlocks() {
-        // Sort blocks by start address
-        std::sort(memory_blocks.begin(), memory_blocks.end(), 
-                  [](const MemoryBlock& a, const MemoryBlock& b) {
-                      return a.start_address < b.start_address;
-                  });
+    // Refresh the derived counters once an allocate/free has settled
+    void publishCounters() {
+        size_t largest = largestFreeBlock();
+        size_t outside_largest = total_free.load(std::memory_order_relaxed) - largest;
+        largest_free.store(largest, std::memory_order_relaxed);
+        external_fragmentation.store(std::max(small_free.load(std::memory_order_relaxed), outside_largest),
+                                     std::memory_order_relaxed);
+    }
+    
+    size_t largestFreeBlock() const {
+        for (int bin = SIZE_BINS - 1; bin >= 0; bin--) {
+            if (!free_by_size[bin].empty()) {
+                return free_by_size[bin].rbegin()->first;
+            }
+        }
+        return 0;
+    }
+    
+    bool findFreeBlock(size_t size, size_t& address) const {
+        int first_bin = sizeBin(size);
         
-        // Merge adjacent free blocks
-        for (size_t i = 0; i < memory_blocks.size() - 1; ) {
-            if (memory_blocks[i].is_free && memory_blocks[i + 1].is_free &&
-                memory_blocks[i].start_address + memory_blocks[i].size == 
-                memory_blocks[i + 1].start_address) {
+        switch (allocation_policy) {
+            case AllocationPolicy::BEST_FIT:
+                // Smallest block that fits: the first fit in the lowest usable bin
+                for (int bin = first_bin; bin < SIZE_BINS; bin++) {
+                    auto it = free_by_size[bin].lower_bound(std::make_pair(size, size_t(0)));
+                    if (it != free_by_size[bin].end()) {
+                        address = it->second;
+                        return true;
+                    }
+                }
+                return false;
+                
+            case AllocationPolicy::WORST_FIT:
+                // Largest free block, if it is big enough
+                for (int bin = SIZE_BINS - 1; bin >= first_bin; bin--) {
+                    if (!free_by_size[bin].empty()) {
+                        if (free_by_size[bin].rbegin()->first < size) {
+                            return false;
+                        }
+                        address = free_by_size[bin].rbegin()->second;
+                        return true;
+                    }
+                }
+                return false;
                 
-                // Merge the blocks
-                memory_blocks[i].size += memory_blocks[i + 1].size;
-                memory_blocks.erase(memory_blocks.begin() + i + 1);
-            } else {
-                i++;
+            case AllocationPolicy::FIRST_FIT:
+            default: {
+                // Lowest address that fits in each usable bin; every block in
+                // a higher bin fits, so there that is simply its lowest block
+                bool found = false;
+                for (int bin = first_bin; bin < SIZE_BINS; bin++) {
+                    size_t candidate;
+                    if (free_by_address[bin].lowestFit(bin == first_bin ? size : 0, candidate) &&
+                        (!found || candidate < address)) {
+                        address = candidate;
+                        found = true;
+                    }
+                }
+                return found;
             }
         }
     }
@@ -0,0 +1,79 @@
+#ifndef MEMORY_SNAPSHOT_H
+#define MEMORY_SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <ctime>
+#include <ostream>
+#include <iomanip>
+
+// One region of a memory snapshot, from its upper address down to its lower
+struct SnapshotRegion {
+    size_t upper;
+    size_t lower;
+    bool is_free;
+    int process_id;    // -1 for free regions
+    std::string label; // Process name (and page) for allocated regions
+};
+
+// Immutable copy of a memory layout, captured on the scheduler thread and
+// formatted later by the snapshot writer
+struct MemorySnapshot {
+    long long sequence; // Quantum number, the N of memory_stamp_N
+    long long tick;
+    std::chrono::system_clock::time_point taken_at;
+    int processes_in_memory;
+    size_t external_fragmentation;
+    size_t total_memory;
+    long long page_faults; // -1 when the memory model has no paging
+    std::vector<SnapshotRegion> regions; // Highest address first
+};
+
+inline std::tm localTime(std::time_t time) {
+    std::tm result;
+#ifdef _WIN32
+    localtime_s(&result, &time);
+#else
+    localtime_r(&time, &result);
+#endif
+    return result;
+}
+
+inline void writeStampHeader(std::ostream& file, const MemorySnapshot& snapshot) {
+    file << "==== memory_stamp_" << snapshot.sequence << " (tick " << snapshot.tick << ") ====\n";
+}
+
+// Same layout the per-quantum memory_stamp_N.txt files used
+inline void writeSnapshotText(std::ostream& file, const MemorySnapshot& snapshot) {
+    std::tm tm_value = localTime(std::chrono::system_clock::to_time_t(snapshot.taken_at));
+    
+    // header
+    file << "Timestamp: (" << std::put_time(&tm_value, "%m/%d/%Y %H:%M:%S") << ")\n";
+    file << "Number of processes in memory: " << snapshot.processes_in_memory << "\n";
+    file << "Total external fragmentation in KB: " << snapshot.external_fragmentation << "\n";
+    if (snapshot.page_faults >= 0) {
+        file << "Page faults: " << snapshot.page_faults << "\n";
+    }
+    file << "\n";
+    
+    file << "----end---- = " << snapshot.total_memory << "\n";
+    for (const SnapshotRegion& region : snapshot.regions) {
+        if (region.is_free) {
+            // Free block - just show the address range
+            file << region.upper << "\n";
+            if (region.lower > 0) {
+                file << "\n"; // Empty line for free space
+            }
+            file << region.lower << "\n";
+        } else {
+            // Allocated block - show process name and its limits
+            file << region.upper << "\n";
+            file << region.label << "\n";
+            file << region.lower << "\n";
+        }
+    }
+    file << "----start---- = 0\n";
+}
+
+#endif
@@ -0,0 +1,173 @@
+#include <vector>
+#include <memory>
+#include <random>
+#include <benchmark/benchmark.h>
+
+#include "process.h"
+#include "bytecode.h"
+#include "string_table.h"
+#include "memory_manager.h"
+
+// Microbenchmarks for the per-tick hot paths, on Google Benchmark.
+// Programs, seeds and allocation patterns are fixed, so two builds can be
+// compared run for run; see the README for the command line.
+
+namespace {
+
+const int PROGRAM_LENGTH = 1024;
+
+// A program made only of one instruction type. FOR is a loop of two
+// iterations around a DECLARE, so it measures loop overhead.
+void buildProgram(Process& process, InstructionType type) {
+    uint32_t message = symbolTable().intern(std::string("Hello world from ") + PROCESS_NAME_PLACEHOLDER + "!");
+    uint32_t name = symbolTable().intern("x");
+    uint32_t operand_a = symbolTable().intern("7");
+    uint32_t operand_b = symbolTable().intern("3");
+    uint32_t sleep_ticks = symbolTable().intern("1");
+    uint16_t slot = 0;
+    process.variable_count = 1;
+    
+    std::vector<Instruction> instructions;
+    while (instructions.size() < PROGRAM_LENGTH) {
+        Instruction inst;
+        inst.type = type;
+        switch (type) {
+            case InstructionType::PRINT:
+                inst.addArg(message);
+                break;
+            case InstructionType::DECLARE:
+                inst.addArg(name);
+                inst.addArg(operand_a);
+                inst.arg_slots[0] = slot;
+                break;
+            case InstructionType::ADD:
+            case InstructionType::SUBTRACT:
+                // Reads the variable back, so slot operands are covered too
+                inst.addArg(name);
+                inst.addArg(name);
+                inst.addArg(operand_b);
+                inst.arg_slots[0] = slot;
+                inst.arg_slots[1] = slot;
+                break;
+            case InstructionType::SLEEP:
+                inst.addArg(sleep_ticks);
+                break;
+            case InstructionType::FOR_START:
+            case InstructionType::FOR_END: {
+                inst.type = InstructionType::FOR_START;
+                inst.for_repeats = 2;
+                instructions.push_back(inst);
+                
+                Instruction body;
+                body.type = InstructionType::DECLARE;
+                body.addArg(name);
+                body.addArg(operand_a);
+                body.arg_slots[0] = slot;
+                instructions.push_back(body);
+                
+                inst = Instruction();
+                inst.type = InstructionType::FOR_END;
+                break;
+            }
+        }
+        instructions.push_back(inst);
+    }
+    
+    compileInstructions(instructions, process.program);
+    process.instruction_count = static_cast<int>(process.program.code.size());
+}
+
+void BM_ExecuteInstruction(benchmark::State& state, InstructionType type) {
+    Process process("bench_execute");
+    buildProgram(process, type);
+    long long tick = 0;
+    
+    // A pass over the program fits in the log, so PRINT never waits on the
+    // spill writer's disk I/O and the timings stay stable
+    process.log = ProcessLog(PROGRAM_LENGTH);
+    
+    for (auto _ : state) {
+        if (!process.executeNextInstruction(0, tick++)) {
+            // Start the program over without timing a new process
+            process.current_instruction = 0;
+            process.for_stack_size = 0;
+            process.state = ProcessState::RUNNING;
+            process.log = ProcessLog(PROGRAM_LENGTH);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_ExecuteInstruction, print, InstructionType::PRINT);
+BENCHMARK_CAPTURE(BM_ExecuteInstruction, declare, InstructionType::DECLARE);
+BENCHMARK_CAPTURE(BM_ExecuteInstruction, add, InstructionType::ADD);
+BENCHMARK_CAPTURE(BM_ExecuteInstruction, subtract, InstructionType::SUBTRACT);
+BENCHMARK_CAPTURE(BM_ExecuteInstruction, sleep, InstructionType::SLEEP);
+BENCHMARK_CAPTURE(BM_ExecuteInstruction, for_loop, InstructionType::FOR_START);
+
+// What admitting a process costs: construction plus the first generated
+// chunk. The rest of a long program is generated while it runs.
+void BM_GenerateRandomInstructions(benchmark::State& state) {
+    int instructions = static_cast<int>(state.range(0));
+    uint64_t seed = 1;
+    
+    for (auto _ : state) {
+        Process process("bench_generate");
+        process.generateRandomInstructions(instructions, instructions, seed++);
+        benchmark::DoNotOptimize(process.program.code.size());
+    }
+}
+BENCHMARK(BM_GenerateRandomInstructions)->Arg(100)->Arg(1000)->Arg(10000)->Arg(1000000);
+
+// Allocates or frees a random process from a pool twice the size memory
+// holds, so memory stays full and blocks keep splitting and coalescing.
+// Args: allocation policy, memory per process (KB); 16 MB in total.
+void BM_MemoryChurn(benchmark::State& state) {
+    const size_t total_memory = 16384;
+    size_t per_process = static_cast<size_t>(state.range(1));
+    MemoryManager memory(total_memory, 16, per_process, static_cast<AllocationPolicy>(state.range(0)));
+    
+    std::vector<std::unique_ptr<Process>> pool;
+    for (size_t i = 0; i < 2 * total_memory / per_process; i++) {
+        pool.emplace_back(new Process("bench_churn"));
+    }
+    std::vector<char> resident(pool.size(), 0);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> pick(0, pool.size() - 1);
+    
+    for (auto _ : state) {
+        size_t i = pick(gen);
+        if (resident[i]) {
+            memory.deallocateMemory(pool[i].get());
+            resident[i] = 0;
+        } else {
+            resident[i] = memory.allocateMemory(pool[i].get());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MemoryChurn)
+    ->ArgNames({"policy", "mem_per_proc"})
+    ->ArgsProduct({{0, 1, 2}, {64, 1024, 4096}});
+
+// Reading the fragmentation counters, as report-util and every tick do
+void BM_TotalExternalFragmentation(benchmark::State& state) {
+    MemoryManager memory(16384, 16, 64, AllocationPolicy::FIRST_FIT);
+    std::vector<std::unique_ptr<Process>> pool;
+    for (int i = 0; i < 256; i++) {
+        pool.emplace_back(new Process("bench_fragmentation"));
+        memory.allocateMemory(pool.back().get());
+    }
+    // Free every other block so there is something to count
+    for (size_t i = 0; i < pool.size(); i += 2) {
+        memory.deallocateMemory(pool[i].get());
+    }
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(memory.getTotalExternalFragmentation());
+    }
+}
+BENCHMARK(BM_TotalExternalFragmentation);
+    
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,353 @@
+#ifndef PAGED_MEMORY_MANAGER_H
+#define PAGED_MEMORY_MANAGER_H
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include "memory_backend.h"
+
+enum class PageReplacement {
+    FIFO,
+    LRU,
+    CLOCK
+};
+
+inline PageReplacement parsePageReplacement(const std::string& name) {
+    if (name == "lru") return PageReplacement::LRU;
+    if (name == "clock") return PageReplacement::CLOCK;
+    return PageReplacement::FIFO;
+}
+
+inline const char* pageReplacementName(PageReplacement policy) {
+    switch (policy) {
+        case PageReplacement::LRU: return "lru";
+        case PageReplacement::CLOCK: return "clock";
+        default: return "fifo";
+    }
+}
+
+// Demand paging: max-overall-mem is split into mem-per-frame frames, and
+// every process gets a page table covering mem-per-proc. Admission never
+// waits for memory; pages are faulted in when the interpreter touches a
+// variable, evicting a frame (FIFO, LRU or clock) when none are free. Dirty
+// victims are written to a backing-store file and read back on the next
+// fault. The frames hold the variable values themselves.
+class PagedMemoryManager : public MemoryBackend, public MemoryAccessHandler {
+private:
+    struct Frame {
+        Process* owner; // nullptr when free
+        int page;
+        bool dirty;
+        bool referenced;
+    };
+    
+    struct PageEntry {
+        int frame = -1;            // Resident frame, or -1
+        long long store_slot = -1; // Backing-store slot with the page image, or -1
+    };
+    
+    size_t total_memory;
+    size_t frame_size;
+    size_t memory_per_process;
+    size_t words_per_frame;
+    PageReplacement replacement;
+    
+    std::vector<uint16_t> physical_memory;
+    std::vector<Frame> frames;
+    std::vector<int> free_frames;
+    std::unordered_map<Process*, std::vector<PageEntry>> page_tables;
+    std::unordered_map<Process*, int> resident_pages; // Only processes with pages in
+    
+    // Resident frames, next victim first: load order under FIFO, least
+    // recently used first under LRU. Clock does not keep it.
+    std::list<int> victim_order;
+    std::vector<std::list<int>::iterator> victim_position;
+    int clock_hand;
+    
+    std::string backing_store_path;
+    std::fstream backing_store;
+    std::vector<long long> free_store_slots;
+    long long next_store_slot;
+    
+    long long page_faults;
+    long long pages_in;
+    long long pages_out;
+    int quantum_cycle_counter;
+    mutable std::mutex paging_mutex;
+    
+public:
+    PagedMemoryManager(size_t total_mem, size_t mem_per_frame, size_t mem_per_proc,
+                       PageReplacement policy = PageReplacement::FIFO,
+                       const std::string& store_path = "csopesy-backing-store.bin")
+        : total_memory(total_mem), frame_size(std::max<size_t>(1, mem_per_frame)),
+          memory_per_process(mem_per_proc), replacement(policy),
+          clock_hand(0), backing_store_path(store_path),
+          next_store_slot(0), page_faults(0), pages_in(0), pages_out(0),
+          quantum_cycle_counter(0) {
+        
+        words_per_frame = std::max<size_t>(1, frame_size / sizeof(uint16_t));
+        size_t frame_count = std::max<size_t>(1, total_memory / frame_size);
+        
+        physical_memory.assign(frame_count * words_per_frame, 0);
+        frames.assign(frame_count, Frame{nullptr, -1, false, false});
+        victim_position.resize(frame_count, victim_order.end());
+        
+        // Hand out low frames first
+        for (size_t i = frame_count; i > 0; i--) {
+            free_frames.push_back(static_cast<int>(i - 1));
+        }
+        
+        backing_store.open(backing_store_path,
+            std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+    
+    // Admission only sets up the page table; nothing is loaded until touched
+    bool allocateMemory(Process* process) override {
+        std::lock_guard<std::mutex> lock(paging_mutex);
+        if (!page_tables.count(process)) {
+            page_tables[process].resize(pagesPerProcess());
+        }
+        return true;
+    }
+    
+    void deallocateMemory(Process* process) override {
+        std::lock_guard<std::mutex> lock(paging_mutex);
+        auto table = page_tables.find(process);
+        if (table == page_tables.end()) {
+            return;
+        }
+        
+        for (PageEntry& entry : table->second) {
+            if (entry.frame >= 0) {
+                releaseFrame(entry.frame);
+            }
+            if (entry.store_slot >= 0) {
+                free_store_slots.push_back(entry.store_slot);
+            }
+        }
+        page_tables.erase(table);
+        resident_pages.erase(process);
+    }
+    
+    bool hasAvailableMemory() const override {
+        return true; // Pages are brought in on demand
+    }
+    
+    int getProcessesInMemory() const override {
+        std::lock_guard<std::mutex> lock(paging_mutex);
+        return static_cast<int>(resident_pages.size());
+    }
+    
+    // Fixed-size frames leave no external fragmentation
+    size_t getTotalExternalFragmentation() const override {
+        return 0;
+    }
+    
+    MemoryAccessHandler* accessHandler() override {
+        return this;
+    }
+    
+    uint16_t readWord(Process* process, size_t address) override {
+        std::lock_guard<std::mutex> lock(paging_mutex);
+        int frame = residentFrame(process, address / frame_size, false);
+        return physical_memory[wordIndex(frame, address)];
+    }
+    
+    void writeWord(Process* process, size_t address, uint16_t value) override {
+        std::lock_guard<std::mutex> lock(paging_mutex);
+        int frame = residentFrame(process, address / frame_size, true);
+        physical_memory[wordIndex(frame, address)] = value;
+    }
+    
+    void printStats(std::ostream& out) const override {
+        std::lock_guard<std::mutex> lock(paging_mutex);
+        out << "Paging (" << pageReplacementName(replacement) << "): "
+            << (frames.size() - free_frames.size()) << "/" << frames.size() << " frames used\n";
+        out << "Page faults: " << page_faults << "\n";
+        out << "Pages paged in: " << pages_in << "\n";
+        out << "Pages paged out: " << pages_out << "\n";
+    }
+    
+    // Occupied frames only; free frames are left out of the layout
+    MemorySnapshot captureSnapshot(long long tick) override {
+        std::lock_guard<std::mutex> lock(paging_mutex);
+        quantum_cycle_counter++;
+        
+        MemorySnapshot snapshot;
+        snapshot.sequence = quantum_cycle_counter;
+        snapshot.tick = tick;
+        snapshot.taken_at = std::chrono::system_clock::now();
+        snapshot.processes_in_memory = static_cast<int>(resident_pages.size());
+        snapshot.external_fragmentation = 0;
+        snapshot.total_memory = total_memory;
+        snapshot.page_faults = page_faults;
+        
+        for (size_t i = frames.size(); i > 0; i--) {
+            const Frame& frame = frames[i - 1];
+            if (!frame.owner) {
+                continue;
+            }
+            SnapshotRegion region;
+            region.upper = i * frame_size;
+            region.lower = (i - 1) * frame_size;
+            region.is_free = false;
+            region.process_id = frame.owner->id;
+            region.label = frame.owner->name + " (page " + std::to_string(frame.page) + ")";
+            snapshot.regions.push_back(std::move(region));
+        }
+        return snapshot;
+    }
+    
+private:
+    size_t pagesPerProcess() const {
+        size_t needed = std::max<size_t>(memory_per_process, MAX_VARIABLES * sizeof(uint16_t));
+        return (needed + frame_size - 1) / frame_size;
+    }
+    
+    // Size of one page image in the backing store
+    std::streamsize pageBytes() const {
+        return static_cast<std::streamsize>(words_per_frame * sizeof(uint16_t));
+    }
+    
+    size_t wordIndex(int frame, size_t address) const {
+        return frame * words_per_frame + (address % frame_size) / sizeof(uint16_t) % words_per_frame;
+    }
+    
+    // Frame holding the page, faulting it in first if needed
+    int residentFrame(Process* process, size_t page, bool write) {
+        std::vector<PageEntry>& table = page_tables[process];
+        if (page >= table.size()) {
+            table.resize(page + 1);
+        }
+        
+        if (table[page].frame < 0) {
+            page_faults++;
+            int frame = takeFrame();
+            loadPage(process, page, frame);
+            table[page].frame = frame;
+        }
+        
+        int frame = table[page].frame;
+        frames[frame].referenced = true;
+        if (write) {
+            frames[frame].dirty = true;
+        }
+        if (replacement == PageReplacement::LRU) {
+            victim_order.splice(victim_order.end(), victim_order, victim_position[frame]);
+        }
+        return frame;
+    }
+    
+    int takeFrame() {
+        if (!free_frames.empty()) {
+            int frame = free_frames.back();
+            free_frames.pop_back();
+            return frame;
+        }
+        
+        int victim = chooseVictim();
+        evict(victim);
+        return victim;
+    }
+    
+    int chooseVictim() {
+        switch (replacement) {
+            case PageReplacement::CLOCK:
+                // Second chance: skip and clear referenced frames
+                while (frames[clock_hand].referenced) {
+                    frames[clock_hand].referenced = false;
+                    clock_hand = (clock_hand + 1) % static_cast<int>(frames.size());
+                }
+                {
+                    int victim = clock_hand;
+                    clock_hand = (clock_hand + 1) % static_cast<int>(frames.size());
+                    return victim;
+                }
+                
+            case PageReplacement::FIFO:
+            case PageReplacement::LRU:
+            default:
+                return victim_order.front();
+        }
+    }
+    
+    void loadPage(Process* process, size_t page, int frame_index) {
+        PageEntry& entry = page_tables[process][page];
+        uint16_t* words = &physical_memory[frame_index * words_per_frame];
+        
+        if (entry.store_slot >= 0) {
+            backing_store.seekg(entry.store_slot * pageBytes());
+            backing_store.read(reinterpret_cast<char*>(words), pageBytes());
+            backing_store.clear();
+            pages_in++;
+        } else {
+            // Never written out: demand-zero page
+            std::fill(words, words + words_per_frame, 0);
+        }
+        
+        Frame& frame = frames[frame_index];
+        frame.owner = process;
+        frame.page = static_cast<int>(page);
+        frame.dirty = false;
+        frame.referenced = true;
+        
+        if (replacement != PageReplacement::CLOCK) {
+            victim_position[frame_index] = victim_order.insert(victim_order.end(), frame_index);
+        }
+        resident_pages[process]++;
+    }
+    
+    // Page the frame's contents out to the backing store if they changed
+    void evict(int frame_index) {
+        Frame& frame = frames[frame_index];
+        PageEntry& entry = page_tables[frame.owner][frame.page];
+        
+        if (frame.dirty) {
+            if (entry.store_slot < 0) {
+                entry.store_slot = allocateStoreSlot();
+            }
+            backing_store.seekp(entry.store_slot * pageBytes());
+            backing_store.write(reinterpret_cast<const char*>(&physical_memory[frame_index * words_per_frame]),
+                                pageBytes());
+            backing_store.clear();
+            pages_out++;
+        }
+        
+        entry.frame = -1;
+        Process* owner = frame.owner;
+        releaseFrameSlot(frame_index);
+        if (--resident_pages[owner] == 0) {
+            resident_pages.erase(owner);
+        }
+    }
+    
+    // Frame of an exiting process: drop it without writing back
+    void releaseFrame(int frame_index) {
+        releaseFrameSlot(frame_index);
+        free_frames.push_back(frame_index);
+    }
+    
+    void releaseFrameSlot(int frame_index) {
+        if (victim_position[frame_index] != victim_order.end()) {
+            victim_order.erase(victim_position[frame_index]);
+            victim_position[frame_index] = victim_order.end();
+        }
+        frames[frame_index] = Frame{nullptr, -1, false, false};
+    }
+    
+    long long allocateStoreSlot() {
+        if (!free_store_slots.empty()) {
+            long long slot = free_store_slots.back();
+            free_store_slots.pop_back();
+            return slot;
+        }
+        return next_store_slot++;
+    }
+};
+
+#endif
@@ -1,188 +1,329 @@
 // Fixed version of process.cpp with proper instruction limit enforcement
 
 #include "process.h"
+#include "string_table.h"
 #include <random>
 #include <thread>
 
 int Process::next_id = 1;
 std::mutex Process::id_mutex;
 
-Process::Process(const std::string& process_name) : 
+Process::Process(const std::string& process_name, int process_id) : 
+    code_base(0),
     name(process_name), 
     state(ProcessState::READY),
+    program(arena),
+    instruction_count(0),
     current_instruction(0),
-    sleep_ticks_remaining(0),
+    variable_count(0),
+    memory_access(nullptr),
+    sleep_ticks_requested(0),
+    wake_tick(0),
+    arrival_tick(0),
+    ready_since_tick(0),
+    waiting_ticks(0),
     cpu_core_assigned(-1),
+    last_core_assigned(-1),
+    priority_level(0),
+    executed_instruction_count(0),
     creation_time(std::chrono::steady_clock::now()),
     total_instructions_executed(0),
     for_stack_size(0) {
     
     std::lock_guard<std::mutex> lock(id_mutex);
-    id = next_id++;
+    if (process_id > 0) {
+        id = process_id;
+        next_id = std::max(next_id, process_id + 1);
+    } else {
+        id = next_id++;
+    }
+    
+    for (int i = 0; i < MAX_VARIABLES; i++) {
+        variables[i] = 0;
+    }
+    
+    log.setOwner(id, name);
     
     // Initialize for loop tracking
     for (int i = 0; i < 3; i++) {
-        for_stack[i] = 0;
         for_current_repeat[i] = 0;
+        for_start_index[i] = 0;
     }
 }
 
-void Process::generateRandomInstructions(int min_ins, int max_ins) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> ins_count_dist(min_ins, max_ins);
-    std::uniform_int_distribution<> ins_type_dist(0, 5);
-    std::uniform_int_distribution<> value_dist(1, 100);
-    std::uniform_int_distribution<> sleep_dist(1, 10);
-    std::uniform_int_distribution<> for_repeat_dist(2, 5);
-    std::uniform_int_distribution<> for_inner_count_dist(1, 3);
-    
-    int instruction_count = ins_count_dist(gen);
-    int max_total_instructions = instruction_count; // Track the absolute maximum
+// Generates a process's program one instruction at a time. This is the
+// old recursive generator turned inside out: each open FOR loop is a frame
+// on an explicit stack, so generation can stop after any instruction and
+// pick up again when execution needs more.
+//
+// It also counts how many instructions the program executes with every FOR
+// loop expanded, as far as it has generated.
+class ProgramGenerator {
+public:
+    ProgramGenerator(Process& process, int min_ins, int max_ins, uint64_t seed)
+        : owner(process),
+          ins_type_dist(0, 5),
+          value_dist(1, 100),
+          sleep_dist(1, 10),
+          for_repeat_dist(2, 5),
+          for_inner_count_dist(1, 3),
+          generated(0),
+          executed_total(0),
+          message(0) {
+        std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+        gen.seed(seq);
+        std::uniform_int_distribution<> ins_count_dist(min_ins, max_ins);
+        max_total_instructions = ins_count_dist(gen);
+        
+        // Every PRINT of every process shares one interned message; the log
+        // fills in the process name when it prints the line
+        static const uint32_t hello_message = symbolTable().intern(std::string("Hello world from ") + PROCESS_NAME_PLACEHOLDER + "!");
+        message = hello_message;
+        frames.push_back(Frame{max_total_instructions, 0, 0, 0, false, 0, 0, 0});
+    }
     
-    generateInstructionsRecursive(instruction_count, gen, ins_type_dist, value_dist, 
-                                sleep_dist, for_repeat_dist, for_inner_count_dist, 
-                                0, max_total_instructions);
-}
-
-void Process::generateInstructionsRecursive(int target_count, std::mt19937& gen, 
-    std::uniform_int_distribution<>& ins_type_dist,
-    std::uniform_int_distribution<>& value_dist,
-    std::uniform_int_distribution<>& sleep_dist,
-    std::uniform_int_distribution<>& for_repeat_dist,
-    std::uniform_int_distribution<>& for_inner_count_dist,
-    int nesting_level,
-    int& max_total_instructions) {
+    int targetCount() const { return max_total_instructions; }
+    int generatedCount() const { return generated; }
     
-    int current_count = 0;
+    // Instructions the program executes with FOR loops expanded. Exact once
+    // the program is complete; until then a lower bound, with open loops
+    // counted once and instructions not generated yet one each.
+    long long executedCount() const {
+        if (frames.empty()) {
+            return executed_total;
+        }
+        long long known = 0;
+        for (const Frame& frame : frames) {
+            known += frame.executed;
+        }
+        return known + (max_total_instructions - generated);
+    }
     
-    while (current_count < target_count && (int)instructions.size() < max_total_instructions) {
-        Instruction inst;
-        int type = ins_type_dist(gen);
+    // Next instruction of the program; false once it is complete
+    bool next(Instruction& inst) {
+        // Literals repeat across processes; look their ids up once
+        thread_local NumberedSymbols literals("");
         
-        // Basic Process Instructions
-        switch (type) {
-            case 0: // PRINT
-                inst.type = InstructionType::PRINT;
-                inst.args.push_back("Hello world from " + name + "!");
-                instructions.push_back(inst);
-                current_count++;
-                break;
-            case 1: // DECLARE
-                inst.type = InstructionType::DECLARE;
-                inst.args.push_back("var" + std::to_string(instructions.size()));
-                inst.args.push_back(std::to_string(value_dist(gen)));
-                instructions.push_back(inst);
-                current_count++;
-                break;
-            case 2: // ADD
-                inst.type = InstructionType::ADD;
-                inst.args.push_back("result" + std::to_string(instructions.size()));
-                inst.args.push_back(std::to_string(value_dist(gen)));
-                inst.args.push_back(std::to_string(value_dist(gen)));
-                instructions.push_back(inst);
-                current_count++;
-                break;
-            case 3: // SUBTRACT
-                inst.type = InstructionType::SUBTRACT;
-                inst.args.push_back("result" + std::to_string(instructions.size()));
-                inst.args.push_back(std::to_string(value_dist(gen)));
-                inst.args.push_back(std::to_string(value_dist(gen)));
-                instructions.push_back(inst);
-                current_count++;
-                break;
-            case 4: // SLEEP
-                inst.type = InstructionType::SLEEP;
-                inst.args.push_back(std::to_string(sleep_dist(gen)));
-                instructions.push_back(inst);
-                current_count++;
-                break;
-            case 5: // FOR
-                {
-                    // Check if we have enough space for at least 3 instructions (FOR_START + 1 inner + FOR_END)
-                    if ((int)instructions.size() + 3 > max_total_instructions) {
-                        // Not enough space for a FOR loop, generate a simple instruction instead
-                        inst.type = InstructionType::PRINT;
-                        inst.args.push_back("Hello world from " + name + "!");
-                        instructions.push_back(inst);
-                        current_count++;
-                        break;
-                    }
-                    
-                    // Add FOR_START (start of loop)
-                    inst.type = InstructionType::FOR_START;
-                    inst.for_repeats = for_repeat_dist(gen);
-                    instructions.push_back(inst);
-                    current_count++;
-                    
-                    // Calculate how many instructions we can still add
-                    int remaining_space = max_total_instructions - (int)instructions.size() - 1; // -1 for FOR_END
-                    
-                    // Generate inner instructions (limited by remaining space)
-                    int inner_count = for_inner_count_dist(gen);
-                    if (inner_count > remaining_space) {
-                        inner_count = std::max(1, remaining_space);
-                    }
-                    
-                    // Calculate remaining budget for this recursive call
-                    int remaining_budget = target_count - current_count - 1; // -1 for FOR_END
-                    if (inner_count > remaining_budget) {
-                        inner_count = std::max(1, remaining_budget);
-                    }
-                    
-                    generateInstructionsRecursive(inner_count, gen, ins_type_dist, value_dist, 
-                        sleep_dist, for_repeat_dist, for_inner_count_dist, nesting_level + 1, 
-                        max_total_instructions);
-                    current_count += inner_count;
-                    
-                    // Add FOR_END (end of loop) - but only if we have space
-                    if ((int)instructions.size() < max_total_instructions) {
-                        Instruction end_inst;
-                        end_inst.type = InstructionType::FOR_END;
-                        instructions.push_back(end_inst);
-                        current_count++;
-                    }
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            
+            if (frame.awaiting_end) {
+                // The loop body is done; close the loop if there is space
+                frame.awaiting_end = false;
+                frame.current_count += frame.inner_count;
+                if (generated < max_total_instructions) {
+                    inst = Instruction();
+                    inst.type = InstructionType::FOR_END;
+                    frame.current_count++;
+                    // The body and the FOR_END run once per repeat
+                    frame.executed += frame.loop_repeats * (frame.body_executed + 1);
+                    return emit();
                 }
-                break;
-            default:
-                inst.type = InstructionType::PRINT;
-                inst.args.push_back("Hello world from " + name + "!");
-                instructions.push_back(inst);
-                current_count++;
-                break;
+                // Cut off before its FOR_END, the body runs once
+                frame.executed += frame.body_executed;
+                continue;
+            }
+            
+            if (frame.current_count >= frame.target_count || generated >= max_total_instructions) {
+                long long executed = frame.executed;
+                frames.pop_back();
+                if (frames.empty()) {
+                    executed_total = executed;
+                } else {
+                    frames.back().body_executed = executed;
+                }
+                continue;
+            }
+            
+            inst = Instruction();
+            int type = ins_type_dist(gen);
+            
+            // Basic Process Instructions
+            switch (type) {
+                case 1: { // DECLARE
+                    inst.type = InstructionType::DECLARE;
+                    int value = value_dist(gen);
+                    inst.addArg(NO_SYMBOL);
+                    inst.addArg(literals.get(value));
+                    inst.arg_slots[0] = owner.allocateVariableSlot();
+                    break;
+                }
+                case 2: // ADD
+                case 3: { // SUBTRACT
+                    inst.type = type == 2 ? InstructionType::ADD : InstructionType::SUBTRACT;
+                    int value_a = value_dist(gen);
+                    int value_b = value_dist(gen);
+                    inst.addArg(NO_SYMBOL);
+                    inst.addArg(literals.get(value_a));
+                    inst.addArg(literals.get(value_b));
+                    inst.arg_slots[0] = owner.allocateVariableSlot();
+                    break;
+                }
+                case 4: { // SLEEP
+                    inst.type = InstructionType::SLEEP;
+                    int ticks = sleep_dist(gen);
+                    inst.addArg(literals.get(ticks));
+                    break;
+                }
+                case 5: // FOR
+                    // Needs space for at least 3 instructions (FOR_START + 1 inner + FOR_END)
+                    // and must stay within the 3 nesting levels the interpreter tracks
+                    if (generated + 3 <= max_total_instructions && frame.nesting_level < 3) {
+                        inst.type = InstructionType::FOR_START;
+                        inst.for_repeats = for_repeat_dist(gen);
+                        frame.current_count++;
+                        frame.executed++;
+                        frame.loop_repeats = inst.for_repeats;
+                        emit();
+                        
+                        // Inner instructions, limited by the remaining space and budget
+                        int remaining_space = max_total_instructions - generated - 1; // -1 for FOR_END
+                        int inner_count = for_inner_count_dist(gen);
+                        if (inner_count > remaining_space) {
+                            inner_count = std::max(1, remaining_space);
+                        }
+                        int remaining_budget = frame.target_count - frame.current_count - 1; // -1 for FOR_END
+                        if (inner_count > remaining_budget) {
+                            inner_count = std::max(1, remaining_budget);
+                        }
+                        
+                        frame.inner_count = inner_count;
+                        frame.awaiting_end = true;
+                        int nesting_level = frame.nesting_level + 1;
+                        frames.push_back(Frame{inner_count, 0, nesting_level, 0, false, 0, 0, 0});
+                        return true;
+                    }
+                    // Not enough space for a FOR loop, generate a simple instruction instead
+                    inst.type = InstructionType::PRINT;
+                    inst.addArg(message);
+                    break;
+                case 0: // PRINT
+                default:
+                    inst.type = InstructionType::PRINT;
+                    inst.addArg(message);
+                    break;
+            }
+            frame.current_count++;
+            frame.executed++;
+            return emit();
         }
+        return false;
+    }
+    
+    // Appends the next chunk of compiled code; false once the program is complete
+    bool generateChunk(ArenaVector<ByteOp>& code, size_t code_base) {
+        Instruction inst;
+        for (int i = 0; i < GENERATION_CHUNK; i++) {
+            if (!next(inst)) {
+                return false;
+            }
+            compiler.append(inst, code, static_cast<uint32_t>(code_base + code.size()));
+        }
+        return true;
+    }
+    
+private:
+    struct Frame {
+        int target_count;
+        int current_count;
+        int nesting_level;
+        int inner_count; // Body size of the loop this frame is inside of
+        bool awaiting_end; // A nested frame is generating a loop body
+        long long executed; // Instructions one pass over this frame executes
+        long long loop_repeats; // Repeats of the loop this frame is inside of
+        long long body_executed; // executed of that loop's body frame, once done
+    };
+    
+    bool emit() {
+        generated++;
+        return true;
+    }
+    
+    Process& owner;
+    std::mt19937 gen;
+    std::uniform_int_distribution<> ins_type_dist;
+    std::uniform_int_distribution<> value_dist;
+    std::uniform_int_distribution<> sleep_dist;
+    std::uniform_int_distribution<> for_repeat_dist;
+    std::uniform_int_distribution<> for_inner_count_dist;
+    int max_total_instructions;
+    int generated;
+    long long executed_total;
+    uint32_t message;
+    std::vector<Frame> frames;
+    ProgramCompiler compiler;
+};
+
+Process::~Process() {}
+
+void Process::resetIds() {
+    std::lock_guard<std::mutex> lock(id_mutex);
+    next_id = 1;
+}
+
+void Process::generateRandomInstructions(int min_ins, int max_ins, uint64_t seed) {
+    generator.reset(new ProgramGenerator(*this, min_ins, max_ins, seed));
+    instruction_count = generator->targetCount();
+    program.code.reserve(std::min(instruction_count, GENERATION_CHUNK));
+    generateChunk();
+}
+
+// Slides the code window up to the oldest instruction that can still run
+// (the outermost open FOR_START, or the current one), then compiles the
+// next chunk behind it
+void Process::generateChunk() {
+    if (!generator) {
+        return;
+    }
+    
+    size_t keep_from = for_stack_size > 0 ? for_start_index[0] : current_instruction;
+    if (keep_from > code_base) {
+        size_t drop = std::min(keep_from - code_base, program.code.size());
+        program.code.erase(program.code.begin(), program.code.begin() + drop);
+        code_base += drop;
+    }
+    
+    // The expanded length is known up to what has been generated
+    bool more = generator->generateChunk(program.code, code_base);
+    executed_instruction_count = generator->executedCount();
+    if (!more) {
+        instruction_count = generator->generatedCount();
+        generator.reset();
     }
 }
 
-bool Process::executeNextInstruction(int delays_per_exec) {
-    if (current_instruction >= instructions.size()) {
+bool Process::hasInstruction(size_t index) {
+    if (index < code_base + program.code.size()) {
+        return true;
+    }
+    generateChunk();
+    return index < code_base + program.code.size();
+}
+
+void Process::releaseProgram() {
+    generator.reset();
+    program.reset();
+    arena.release();
+}
+
+bool Process::executeNextInstruction(int delays_per_exec, long long tick) {
+    if (!hasInstruction(current_instruction)) {
         state = ProcessState::FINISHED;
         finish_time = std::chrono::steady_clock::now();
         return false; // Process finished
     }
     
-    const Instruction& inst = instructions[current_instruction];
-    
-    // Handle sleep state
-    if (sleep_ticks_remaining > 0) {
-        sleep_ticks_remaining--;
-        if (sleep_ticks_remaining == 0) {
-            state = ProcessState::READY;
-        } else {
-            state = ProcessState::WAITING;
-            return true; // Don't advance instruction while sleeping
-        }
-    }
+    const ByteOp& op = program.code[current_instruction - code_base];
     
     // Execute the current instruction
-    executeInstruction(inst);
+    executeInstruction(op, tick);
     total_instructions_executed++;
     
     // Advance to next instruction
     current_instruction++;
     
     // Check if finished
-    if (current_instruction >= instructions.size()) {
+    if (!hasInstruction(current_instruction)) {
         state = ProcessState::FINISHED;
         finish_time = std::chrono::steady_clock::now();
         return false; // Process finished
@@ -195,84 +336,96 @@ bool Process::executeNextInstruction(int delays_per_exec) {
     return true;
 }
 
-void Process::executeInstruction(const Instruction& inst) {
-    switch (inst.type) {
-        case InstructionType::PRINT: {
-            std::string output = inst.args[0];
-            addOutput(output);
+void Process::executeInstruction(const ByteOp& op, long long tick) {
+    switch (op.op) {
+        case OpCode::PRINT:
+            addOutput(op.a, tick);
             break;
-        }
-        case InstructionType::DECLARE: {
-            if (inst.args.size() >= 2) {
-                std::string var_name = inst.args[0];
-                uint16_t value = static_cast<uint16_t>(std::stoi(inst.args[1]));
-                variables[var_name] = value;
-            }
+        case OpCode::DECLARE:
+            setVariable(op.dst, static_cast<uint16_t>(op.a));
             break;
-        }
-        case InstructionType::ADD: {
-            if (inst.args.size() >= 3) {
-                std::string result_var = inst.args[0];
-                uint16_t val1 = std::stoi(evaluateExpression(inst.args[1]));
-                uint16_t val2 = std::stoi(evaluateExpression(inst.args[2]));
-                variables[result_var] = val1 + val2;
-            }
+        case OpCode::ADD: {
+            uint16_t val1 = operandValue(op.a, op.flags & OPERAND_A_SLOT);
+            uint16_t val2 = operandValue(op.b, op.flags & OPERAND_B_SLOT);
+            setVariable(op.dst, val1 + val2);
             break;
         }
-        case InstructionType::SUBTRACT: {
-            if (inst.args.size() >= 3) {
-                std::string result_var = inst.args[0];
-                uint16_t val1 = std::stoi(evaluateExpression(inst.args[1]));
-                uint16_t val2 = std::stoi(evaluateExpression(inst.args[2]));
-                variables[result_var] = (val1 > val2) ? val1 - val2 : 0;
-            }
+        case OpCode::SUBTRACT: {
+            uint16_t val1 = operandValue(op.a, op.flags & OPERAND_A_SLOT);
+            uint16_t val2 = operandValue(op.b, op.flags & OPERAND_B_SLOT);
+            setVariable(op.dst, (val1 > val2) ? val1 - val2 : 0);
             break;
         }
-        case InstructionType::SLEEP: {
-            if (!inst.args.empty()) {
-                sleep_ticks_remaining = std::stoi(inst.args[0]);
+        case OpCode::SLEEP:
+            if (op.a > 0) {
+                // The scheduler parks the process on its timer wheel
+                sleep_ticks_requested = op.a;
                 state = ProcessState::WAITING;
             }
             break;
-        }
-        case InstructionType::FOR_START: {
-            // Push current position onto for stack
-            if (for_stack_size < 3) {
-                for_stack[for_stack_size] = current_instruction; // Store FOR_START position
-                for_current_repeat[for_stack_size] = 1; // Start with iteration 1
-                for_stack_size++;
-            }
+        case OpCode::FOR_START:
+            // Start counting iterations at this loop's nesting depth
+            for_current_repeat[op.dst] = 1;
+            for_start_index[op.dst] = current_instruction;
+            for_stack_size = op.dst + 1;
             break;
-        }
-        case InstructionType::FOR_END: {
-            if (for_stack_size > 0) {
-                int current_level = for_stack_size - 1;
-                int for_start_index = for_stack[current_level];
-                
-                // Get the FOR_START instruction to check repeat count
-                const Instruction& for_start_inst = instructions[for_start_index];
-                
-                // Check if we need more iterations
-                if (for_current_repeat[current_level] < for_start_inst.for_repeats) {
-                    for_current_repeat[current_level]++; // Increment iteration count
-                    current_instruction = for_start_index; // Jump back to FOR_START
-                } else {
-                    for_stack_size--;
-                }
+        case OpCode::FOR_END:
+            if (op.a == NO_JUMP_TARGET) {
+                break;
+            }
+            
+            // Check if we need more iterations
+            if (for_current_repeat[op.dst] < (int)op.b) {
+                for_current_repeat[op.dst]++; // Increment iteration count
+                current_instruction = op.a; // Jump back to FOR_START
+            } else {
+                for_stack_size = op.dst;
             }
             break;
-        }
     }
 }
 
-std::string Process::evaluateExpression(const std::string& expr) {
-    // Check if it's a variable
-    if (variables.find(expr) != variables.end()) {
-        return std::to_string(variables[expr]);
+ProcessView Process::view() const {
+    ProcessView view;
+    view.name = name;
+    view.id = id;
+    view.state = state;
+    view.cpu_core_assigned = cpu_core_assigned;
+    view.current_instruction = current_instruction;
+    view.instruction_count = instruction_count;
+    view.wake_tick = state == ProcessState::WAITING ? wake_tick : 0;
+    // The next chunk may not be generated yet
+    view.has_current_op = current_instruction >= (int)code_base &&
+                          current_instruction < (int)(code_base + program.code.size());
+    view.current_op = OpCode::PRINT;
+    view.current_operand = 0;
+    
+    if (view.has_current_op) {
+        const ByteOp& op = program.code[current_instruction - code_base];
+        view.current_op = op.op;
+        view.current_operand = op.a;
     }
-    return expr;
+    return view;
+}
+
+ProcessRecord Process::toRecord() {
+    ProcessRecord record;
+    record.name = name;
+    record.id = id;
+    record.creation_time = creation_time;
+    record.finish_time = finish_time;
+    record.instruction_count = instruction_count;
+    record.arrival_tick = arrival_tick;
+    record.finish_tick = 0; // Set by the scheduler when it retires the process
+    record.waiting_ticks = waiting_ticks;
+    record.log = std::make_shared<const ProcessLog>(std::move(log));
+    return record;
 }
 
-void Process::addOutput(const std::string& output) {
-    output_logs.push_back(output);
+void Process::addOutput(uint32_t message_id, long long tick) {
+    LogRecord record;
+    record.tick = tick;
+    record.core = cpu_core_assigned;
+    record.message_id = message_id;
+    log.append(record);
 }
\ No newline at end of file
@@ -7,7 +7,11 @@
 #include <mutex>
 #include <chrono>
 #include <random>
+#include <memory>
 #include "instruction.h"
+#include "bytecode.h"
+#include "arena.h"
+#include "process_log.h"
 
 enum class ProcessState {
     READY,
@@ -16,51 +20,155 @@ enum class ProcessState {
     FINISHED
 };
 
+class Process;
+class ProgramGenerator;
+
+// Instructions generated per step; only this window of a program (plus any
+// loop still being repeated) is kept as bytecode
+const int GENERATION_CHUNK = 256;
+
+// Memory unit the interpreter goes through for variable reads and writes
+// when the process lives in paged memory. Addresses are byte offsets into
+// the process's own address space; the symbol table starts at 0.
+class MemoryAccessHandler {
+public:
+    virtual ~MemoryAccessHandler() {}
+    virtual uint16_t readWord(Process* process, size_t address) = 0;
+    virtual void writeWord(Process* process, size_t address, uint16_t value) = 0;
+};
+
+// Compact record kept for a finished process once the scheduler retires it
+// from its active set
+struct ProcessRecord {
+    std::string name;
+    int id;
+    std::chrono::steady_clock::time_point creation_time;
+    std::chrono::steady_clock::time_point finish_time;
+    int instruction_count;
+    long long arrival_tick;
+    long long finish_tick;
+    long long waiting_ticks;
+    std::shared_ptr<const ProcessLog> log;
+};
+
+// Copy of the fields the CLI shows for a live process, taken under the
+// scheduler lock so it stays valid after the process is retired
+struct ProcessView {
+    std::string name;
+    int id;
+    ProcessState state;
+    int cpu_core_assigned;
+    int current_instruction;
+    int instruction_count;
+    long long wake_tick; // Tick a WAITING process is due back, else 0
+    bool has_current_op; // False once past the end of the program
+    OpCode current_op;
+    uint32_t current_operand;
+    
+    // Derived when read, so a sleeping process's view stays the same
+    // from tick to tick
+    int sleepTicksRemaining(long long tick) const {
+        return wake_tick > tick ? static_cast<int>(wake_tick - tick) : 0;
+    }
+};
+
 class Process {
 private:
+    friend class ProgramGenerator;
+    
     static int next_id;
     static std::mutex id_mutex;
+    std::unique_ptr<ProgramGenerator> generator; // Rest of the program; null once fully generated
+    size_t code_base; // Program counter of program.code[0]
     
 public:
     int id;
     std::string name;
     ProcessState state;
-    std::vector<Instruction> instructions;
+    Arena arena; // Backs program; must be declared before it
+    Program program; // Window of compiled instructions, what actually executes
+    int instruction_count; // Length of program (the target until fully generated)
     int current_instruction;
-    std::map<std::string, uint16_t> variables;
-    std::vector<std::string> output_logs;
-    int sleep_ticks_remaining;
+    uint16_t variables[MAX_VARIABLES]; // Symbol table, unless memory_access is set
+    int variable_count; // Slots handed out so far
+    MemoryAccessHandler* memory_access; // Paged memory, or nullptr
+    ProcessLog log; // PRINT output, bounded; older records spill to disk
+    int sleep_ticks_requested; // Length of the last SLEEP, picked up by the scheduler
+    long long wake_tick; // Tick a WAITING process is due back on the ready queue
+    long long arrival_tick; // Tick the scheduler admitted the process
+    long long ready_since_tick; // Start of the current wait to be dispatched
+    long long waiting_ticks; // Ticks spent waiting for memory or a core
     int cpu_core_assigned;
+    int last_core_assigned; // Core the process last ran on, for ready lane affinity
+    int priority_level; // MLFQ queue level, 0 is the highest; always 0 under FCFS/RR
+    long long executed_instruction_count; // Instructions the program executes, FOR loops expanded
     std::chrono::steady_clock::time_point creation_time;
     std::chrono::steady_clock::time_point finish_time;
-    int for_stack[3]; // For nested loops (max 3 levels)
-    int for_stack_size;
+    int for_stack_size; // Current FOR nesting depth (max 3 levels)
     int for_current_repeat[3];
+    int for_start_index[3]; // Program counter of each open FOR_START
     int total_instructions_executed;
     
-    Process(const std::string& process_name);
+    // process_id 0 takes the next free id; a replay passes the recorded one
+    explicit Process(const std::string& process_name, int process_id = 0);
+    ~Process();
+    
+    // Start ids at 1 again; only between runs, with no processes left
+    static void resetIds();
     
-    void generateRandomInstructions(int min_ins, int max_ins);
-    bool executeNextInstruction(int delays_per_exec);
-    void addOutput(const std::string& output);
+    // Same seed, same program: runs with a fixed master seed are reproducible.
+    // Only the first chunk is generated here, the rest as execution reaches it.
+    void generateRandomInstructions(int min_ins, int max_ins, uint64_t seed);
+    bool executeNextInstruction(int delays_per_exec, long long tick);
+    void addOutput(uint32_t message_id, long long tick);
     bool isFinished() const { return state == ProcessState::FINISHED; }
-
+    
     double getCompletionPercentage() const {
-        if (instructions.empty()) return 0.0;
-        return (static_cast<double>(total_instructions_executed) / instructions.size()) * 100.0;
+        if (instruction_count == 0) return 0.0;
+        return (static_cast<double>(total_instructions_executed) / instruction_count) * 100.0;
     }
     
+    // Instructions left to execute, FOR loops expanded
+    long long remainingInstructions() const { return executed_instruction_count - total_instructions_executed; }
+    
+    ProcessView view() const;
+    ProcessRecord toRecord(); // Moves the log into the record
+    
+    // Free the program in one shot once the finished process is reclaimed
+    void releaseProgram();
+    
 private:
-    void executeInstruction(const Instruction& inst);
-    std::string evaluateExpression(const std::string& expr);
-
-    void generateInstructionsRecursive(int target_count, std::mt19937& gen, 
-        std::uniform_int_distribution<>& ins_type_dist,
-        std::uniform_int_distribution<>& value_dist,
-        std::uniform_int_distribution<>& sleep_dist,
-        std::uniform_int_distribution<>& for_repeat_dist,
-        std::uniform_int_distribution<>& for_inner_count_dist,
-        int nesting_level, int& max_total_instructions);
+    void executeInstruction(const ByteOp& op, long long tick);
+    
+    uint16_t operandValue(uint32_t operand, bool is_slot) {
+        return is_slot ? readVariable(static_cast<uint16_t>(operand)) : static_cast<uint16_t>(operand);
+    }
+    
+    uint16_t readVariable(uint16_t slot) {
+        if (memory_access) {
+            return memory_access->readWord(this, slot * sizeof(uint16_t));
+        }
+        return variables[slot];
+    }
+    
+    // Writes to a variable that did not fit in the symbol table are ignored
+    void setVariable(uint16_t slot, uint16_t value) {
+        if (slot == NO_VARIABLE_SLOT) {
+            return;
+        }
+        if (memory_access) {
+            memory_access->writeWord(this, slot * sizeof(uint16_t), value);
+        } else {
+            variables[slot] = value;
+        }
+    }
+    
+    uint16_t allocateVariableSlot() {
+        return variable_count < MAX_VARIABLES ? variable_count++ : NO_VARIABLE_SLOT;
+    }
+    
+    bool hasInstruction(size_t index);
+    void generateChunk();
 };
 
 #endif
\ No newline at end of file
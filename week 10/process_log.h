@@ -0,0 +1,313 @@
+#ifndef PROCESS_LOG_H
+#define PROCESS_LOG_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <algorithm>
+#include "string_table.h"
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// One PRINT, 16 bytes instead of a full message string
+struct LogRecord {
+    long long tick;
+    int32_t core;
+    uint32_t message_id; // Into symbolTable()
+};
+
+// A PRINT message may contain this; it is replaced by the name of the
+// process that printed it when the line is formatted, so one interned
+// message serves every process
+const char* const PROCESS_NAME_PLACEHOLDER = "{name}";
+
+inline std::string formatLogRecord(const LogRecord& record, const std::string& owner) {
+    std::string message = symbolTable().text(record.message_id);
+    size_t at = message.find(PROCESS_NAME_PLACEHOLDER);
+    if (at != std::string::npos) {
+        message.replace(at, std::char_traits<char>::length(PROCESS_NAME_PLACEHOLDER), owner);
+    }
+    
+    std::ostringstream line;
+    line << "(tick " << record.tick << ") Core:" << record.core << " \"" << message << "\"";
+    return line.str();
+}
+
+// Background thread that appends spilled log records to per-process files
+// under process_logs/. Files are written in the same line format the
+// process-smi screen prints. Callers never wait on disk: when MAX_PENDING
+// batches are queued the records are dropped, and written later as one
+// placeholder line each so line numbers in the file stay right.
+class LogSpillWriter {
+private:
+    struct Batch {
+        std::string path;
+        std::string owner; // Process name, for the message placeholder
+        bool truncate; // First spill of a process starts a fresh file
+        bool remove;   // Delete the file instead of writing to it
+        size_t dropped; // Placeholder lines written before the records
+        std::vector<LogRecord> records;
+    };
+    
+    // Records of a file dropped while the queue was full
+    struct Gap {
+        bool truncate = false;
+        size_t records = 0;
+    };
+    
+    static const size_t MAX_PENDING = 1024;
+    
+    std::deque<Batch> pending;
+    std::unordered_map<std::string, Gap> gaps;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::condition_variable idle_cv;
+    std::thread writer_thread;
+    bool stopping = false;
+    bool writing = false;
+    long long dropped_records = 0;
+    
+public:
+    ~LogSpillWriter() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_cv.notify_one();
+        if (writer_thread.joinable()) {
+            writer_thread.join();
+        }
+    }
+    
+    static std::string directory() { return "process_logs"; }
+    
+    // Never blocks on I/O; returns false if the records had to be dropped
+    bool submit(const std::string& path, const std::string& owner, bool truncate, std::vector<LogRecord>&& records) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            startWriter();
+            if (pending.size() >= MAX_PENDING) {
+                Gap& gap = gaps[path];
+                gap.truncate = gap.truncate || truncate;
+                gap.records += records.size();
+                dropped_records += records.size();
+                return false;
+            }
+            
+            Batch batch{path, owner, truncate, false, 0, std::move(records)};
+            auto gap = gaps.find(path);
+            if (gap != gaps.end()) {
+                batch.truncate = batch.truncate || gap->second.truncate;
+                batch.dropped = gap->second.records;
+                gaps.erase(gap);
+            }
+            pending.push_back(std::move(batch));
+        }
+        queue_cv.notify_one();
+        return true;
+    }
+    
+    // Deletes the file once everything queued before it is written. Never
+    // dropped, so it may go past MAX_PENDING.
+    void remove(const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            startWriter();
+            gaps.erase(path);
+            pending.push_back(Batch{path, std::string(), false, true, 0, std::vector<LogRecord>()});
+        }
+        queue_cv.notify_one();
+    }
+    
+    // Wait until everything submitted so far is on disk
+    void flush() {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        idle_cv.wait(lock, [this] { return pending.empty() && gaps.empty() && !writing; });
+    }
+    
+    long long droppedRecords() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return dropped_records;
+    }
+    
+private:
+    // Caller holds queue_mutex
+    void startWriter() {
+        if (!writer_thread.joinable()) {
+            makeDirectory();
+            writer_thread = std::thread(&LogSpillWriter::writerLoop, this);
+        }
+    }
+    
+    static void makeDirectory() {
+#ifdef _WIN32
+        _mkdir(directory().c_str());
+#else
+        mkdir(directory().c_str(), 0755);
+#endif
+    }
+    
+    void writerLoop() {
+        while (true) {
+            Batch batch;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [this] { return stopping || !pending.empty() || !gaps.empty(); });
+                if (!pending.empty()) {
+                    batch = std::move(pending.front());
+                    pending.pop_front();
+                } else if (!gaps.empty()) {
+                    // Nothing more came for the file; write its placeholders now
+                    auto gap = gaps.begin();
+                    batch = Batch{gap->first, std::string(), gap->second.truncate, false, gap->second.records,
+                                  std::vector<LogRecord>()};
+                    gaps.erase(gap);
+                } else {
+                    break;
+                }
+                writing = true;
+            }
+            
+            if (batch.remove) {
+                std::remove(batch.path.c_str());
+            } else {
+                writeBatch(batch);
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                writing = false;
+            }
+            idle_cv.notify_all();
+        }
+    }
+    
+    static void writeBatch(const Batch& batch) {
+        std::ios::openmode mode = std::ios::out | (batch.truncate ? std::ios::trunc : std::ios::app);
+        std::ofstream file(batch.path, mode);
+        std::string lines;
+        for (size_t i = 0; i < batch.dropped; i++) {
+            lines += "(log record dropped: spill queue full)\n";
+        }
+        for (const LogRecord& record : batch.records) {
+            lines += formatLogRecord(record, batch.owner);
+            lines += '\n';
+        }
+        file << lines;
+    }
+};
+
+inline LogSpillWriter& logSpillWriter() {
+    static LogSpillWriter writer;
+    return writer;
+}
+
+// Fixed-capacity ring of a process's log records. When the ring is full the
+// oldest half is handed to the spill writer, so memory stays bounded however
+// many times a FOR loop prints. Record i counts from the first PRINT: the
+// first spilledCount() records are on disk, the rest in the ring.
+class ProcessLog {
+private:
+    std::vector<LogRecord> ring;
+    size_t capacity;
+    size_t head = 0;  // Oldest record in the ring
+    size_t count = 0;
+    size_t spilled = 0;
+    std::string owner_name;
+    std::string spill_path;
+    
+    // Deletes the spill file once no copy of the log refers to it
+    struct SpillFile {
+        std::string path;
+        explicit SpillFile(const std::string& file_path) : path(file_path) {}
+        ~SpillFile() { logSpillWriter().remove(path); }
+    };
+    std::shared_ptr<const SpillFile> spill_file; // Null until the first spill
+    
+public:
+    static const size_t DEFAULT_CAPACITY = 100;
+    
+    explicit ProcessLog(size_t max_records = DEFAULT_CAPACITY)
+        : capacity(max_records > 0 ? max_records : 1) {}
+    
+    // The spill file is keyed on the id: names can repeat, ids are unique
+    // within a run
+    void setOwner(int process_id, const std::string& process_name) {
+        owner_name = process_name;
+        spill_path = LogSpillWriter::directory() + "/" + std::to_string(process_id) + ".txt";
+    }
+    
+    // Only before the first record is appended
+    void setCapacity(size_t max_records) {
+        capacity = max_records > 0 ? max_records : 1;
+    }
+    
+    void append(const LogRecord& record) {
+        if (ring.size() < capacity) {
+            ring.resize(capacity);
+        }
+        if (count == capacity) {
+            spillOldest();
+        }
+        ring[(head + count) % capacity] = record;
+        count++;
+    }
+    
+    size_t size() const { return spilled + count; }
+    size_t spilledCount() const { return spilled; }
+    
+    // Formatted lines [first, first + max_lines), read back from the spill
+    // file for records that are no longer in the ring
+    std::vector<std::string> lines(size_t first, size_t max_lines) const {
+        std::vector<std::string> result;
+        size_t end = std::min(size(), first + max_lines);
+        
+        if (first < spilled && first < end) {
+            logSpillWriter().flush();
+            std::ifstream file(spill_path);
+            std::string line;
+            for (size_t i = 0; i < std::min(end, spilled) && std::getline(file, line); i++) {
+                if (i >= first) {
+                    result.push_back(line);
+                }
+            }
+        }
+        
+        for (size_t i = std::max(first, spilled); i < end; i++) {
+            result.push_back(formatLogRecord(ring[(head + i - spilled) % capacity], owner_name));
+        }
+        return result;
+    }
+    
+private:
+    void spillOldest() {
+        size_t batch_size = std::max<size_t>(1, capacity / 2);
+        std::vector<LogRecord> batch;
+        batch.reserve(batch_size);
+        for (size_t i = 0; i < batch_size; i++) {
+            batch.push_back(ring[(head + i) % capacity]);
+        }
+        
+        if (!spill_file) {
+            spill_file = std::make_shared<const SpillFile>(spill_path);
+        }
+        logSpillWriter().submit(spill_path, owner_name, spilled == 0, std::move(batch));
+        head = (head + batch_size) % capacity;
+        count -= batch_size;
+        spilled += batch_size;
+    }
+};
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef READY_QUEUE_H
+#define READY_QUEUE_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include "process.h"
+
+// Ready queue split into one FIFO lane per core. A core dispatches from its
+// own lane and, when that is empty, steals the oldest process of the longest
+// other lane. Lanes are always taken from the front so FCFS/RR order holds
+// within every lane. With a single lane this is the old global ready queue.
+//
+// For MLFQ every priority level has its own set of lanes, and a process is
+// queued at its priority_level. pop() serves the highest non-empty level
+// first (level 0 is the highest) and only then looks at core affinity.
+// FCFS and RR use a single level.
+class ReadyQueue {
+private:
+    struct Lane {
+        std::mutex lane_mutex;
+        std::deque<Process*> processes;
+        std::atomic<int> size{0};
+    };
+    
+    std::vector<std::unique_ptr<Lane>> lanes; // Level-major: lanes[level * lanes_per_level + lane]
+    std::unique_ptr<std::atomic<int>[]> level_sizes;
+    int lanes_per_level = 1;
+    int level_count = 1;
+    std::atomic<int> next_lane{0};
+    std::atomic<int> total_size{0};
+    
+public:
+    void initialize(int lane_count, int levels = 1) {
+        lanes_per_level = std::max(1, lane_count);
+        level_count = std::max(1, levels);
+        lanes.clear();
+        for (int i = 0; i < lanes_per_level * level_count; i++) {
+            lanes.emplace_back(new Lane());
+        }
+        level_sizes.reset(new std::atomic<int>[level_count]);
+        for (int level = 0; level < level_count; level++) {
+            level_sizes[level] = 0;
+        }
+        next_lane = 0;
+        total_size = 0;
+    }
+    
+    int laneCount() const { return lanes_per_level; }
+    int levelCount() const { return level_count; }
+    
+    // Queue a process at its priority level, on the lane of the given core,
+    // or spread new work round-robin over the lanes when no core is given
+    void push(Process* process, int core = -1) {
+        int lane_index = core;
+        if (lane_index < 0 || lane_index >= lanes_per_level) {
+            lane_index = next_lane.fetch_add(1) % lanes_per_level;
+        }
+        int level = std::min(std::max(process->priority_level, 0), level_count - 1);
+        
+        Lane& lane = *lanes[level * lanes_per_level + lane_index];
+        std::lock_guard<std::mutex> lock(lane.lane_mutex);
+        lane.processes.push_back(process);
+        lane.size++;
+        level_sizes[level]++;
+        total_size++;
+    }
+    
+    // Next process for the given core, or nullptr if every lane is empty
+    Process* pop(int core) {
+        int home = (core >= 0 && core < lanes_per_level) ? core : 0;
+        
+        for (int level = 0; level < level_count && total_size > 0; level++) {
+            Process* process = popLevel(level, home);
+            if (process) {
+                return process;
+            }
+        }
+        return nullptr;
+    }
+    
+    // Processes waiting at levels above (numerically below) the given one
+    int waitingAbove(int level) const {
+        int waiting = 0;
+        for (int above = 0; above < std::min(level, level_count); above++) {
+            waiting += level_sizes[above];
+        }
+        return waiting;
+    }
+    
+    // MLFQ priority boost: moves every queued process up to level 0, behind
+    // the ones already there and keeping its lane and queue order. The
+    // caller resets priority_level; no pop may run concurrently.
+    void promoteAll() {
+        for (int level = 1; level < level_count; level++) {
+            for (int lane_index = 0; lane_index < lanes_per_level; lane_index++) {
+                Lane& from = *lanes[level * lanes_per_level + lane_index];
+                Lane& to = *lanes[lane_index];
+                std::lock_guard<std::mutex> from_lock(from.lane_mutex);
+                std::lock_guard<std::mutex> to_lock(to.lane_mutex);
+                int moved = static_cast<int>(from.processes.size());
+                to.processes.insert(to.processes.end(), from.processes.begin(), from.processes.end());
+                from.processes.clear();
+                from.size = 0;
+                to.size += moved;
+                level_sizes[level] -= moved;
+                level_sizes[0] += moved;
+            }
+        }
+    }
+    
+    bool empty() const { return total_size == 0; }
+    int size() const { return total_size; }
+    
+private:
+    Process* popLevel(int level, int home) {
+        if (level_sizes[level] == 0) {
+            return nullptr;
+        }
+        
+        Process* process = popFront(level, home);
+        if (process) {
+            return process;
+        }
+        
+        // Own lane is empty: steal from the lane with the most waiting work
+        while (level_sizes[level] > 0) {
+            int victim = -1;
+            int victim_size = 0;
+            for (int offset = 1; offset < lanes_per_level; offset++) {
+                int index = (home + offset) % lanes_per_level;
+                int size = lanes[level * lanes_per_level + index]->size;
+                if (size > victim_size) {
+                    victim = index;
+                    victim_size = size;
+                }
+            }
+            
+            if (victim < 0) {
+                return nullptr;
+            }
+            
+            process = popFront(level, victim);
+            if (process) {
+                return process;
+            }
+        }
+        return nullptr;
+    }
+    
+    Process* popFront(int level, int lane_index) {
+        Lane& lane = *lanes[level * lanes_per_level + lane_index];
+        if (lane.size == 0) {
+            return nullptr;
+        }
+        
+        std::lock_guard<std::mutex> lock(lane.lane_mutex);
+        if (lane.processes.empty()) {
+            return nullptr;
+        }
+        
+        Process* process = lane.processes.front();
+        lane.processes.pop_front();
+        lane.size--;
+        level_sizes[level]--;
+        total_size--;
+        return process;
+    }
+};
+
+#endif
@@ -2,30 +2,97 @@
 #include <thread>
 #include <chrono>
 #include <algorithm>
+#include <random>
+#include <sstream>
 
 void Scheduler::initialize(const Config& cfg) {
     config = cfg;
-    cpu_cores_busy.resize(config.num_cpu, false);
+    cpu_cores_busy.resize(config.num_cpu, 0);
     running_processes.resize(config.num_cpu, nullptr);
     process_time_slice.resize(config.num_cpu, 0);
+    core_continuing.resize(config.num_cpu, 0);
+    core_stepped.resize(config.num_cpu, 0);
     
     // Initialize memory manager
-    memory_manager = std::make_unique<MemoryManager>(
-        config.max_overall_mem, 
-        config.mem_per_frame, 
-        config.mem_per_proc
-    );
+    if (config.memory_model == "paging") {
+        memory_manager.reset(new PagedMemoryManager(
+            config.max_overall_mem,
+            config.mem_per_frame,
+            config.mem_per_proc,
+            parsePageReplacement(config.page_replacement)
+        ));
+    } else {
+        memory_manager.reset(new MemoryManager(
+            config.max_overall_mem, 
+            config.mem_per_frame, 
+            config.mem_per_proc,
+            parseAllocationPolicy(config.mem_alloc)
+        ));
+    }
+    snapshot_writer.setFormat(config.snapshot_format);
+    
+    if (config.seed != 0) {
+        master_seed = config.seed;
+    } else {
+        std::random_device rd;
+        master_seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+    
+    // A replay admits processes from the trace and runs without sleeps
+    if (config.trace_mode == "record") {
+        std::ostringstream config_text;
+        writeConfig(config_text, config);
+        trace.startRecording(config.trace_file, master_seed, config_text.str());
+    } else if (config.trace_mode == "replay" && trace.startReplay(config.trace_file)) {
+        config.tick_mode = "fast";
+        config.delays_per_exec = 0;
+    }
+    central_dispatch = config.exec_mode != "parallel" || trace.getMode() != SchedulerTrace::Mode::OFF;
+    fast_ticks = config.tick_mode == "fast";
+    
+    // The only place config.scheduler is looked at; unknown names get RR
+    if (config.scheduler == "fcfs") {
+        usePolicy<FcfsPolicy>();
+    } else if (config.scheduler == "mlfq") {
+        usePolicy<MlfqPolicy>();
+    } else if (config.scheduler == "sjf") {
+        usePolicy<SjfPolicy>();
+    } else if (config.scheduler == "srtf") {
+        usePolicy<SrtfPolicy>();
+    } else {
+        usePolicy<RoundRobinPolicy>();
+    }
+}
+
+// Instantiates the tick loop for the policy
+template <class Policy>
+void Scheduler::usePolicy() {
+    std::get<Policy>(policies).initialize(config);
+    tick_loop = &Scheduler::runTickWith<Policy>;
+    step_core = &Scheduler::stepCore<Policy>;
+    make_ready = &Scheduler::makeReady<Policy>;
+}
+
+// For callers outside the tick loop: admission, and memory freed up
+template <class Policy>
+void Scheduler::makeReady(Process* process, int core) {
+    std::get<Policy>(policies).push(process, core);
 }
 
 void Scheduler::startScheduler() {
     if (!scheduler_running) {
         scheduler_running = true;
+        snapshot_writer.start();
+        generator_pool.start(config.generator_threads, config.min_ins, config.max_ins);
+        if (config.exec_mode == "parallel") {
+            startCoreWorkers();
+        }
         scheduler_thread = std::thread(&Scheduler::schedulerLoop, this);
     }
 }
 
 void Scheduler::stopScheduler() {
-    scheduler_running = false;
+    bool was_running = scheduler_running.exchange(false);
     process_generation_active = false;
     
     if (scheduler_thread.joinable()) {
@@ -34,12 +101,67 @@ void Scheduler::stopScheduler() {
     if (process_generator_thread.joinable()) {
         process_generator_thread.join();
     }
+    
+    // Workers can only be released once the scheduler thread stopped ticking
+    stopCoreWorkers();
+    generator_pool.stop();
+    snapshot_writer.stop();
+    
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    if (was_running) {
+        trace.finish(cpu_ticks);
+    }
+    publishStats();
+}
+
+void Scheduler::startCoreWorkers() {
+    tick_start_barrier.reset(config.num_cpu + 1);
+    tick_end_barrier.reset(config.num_cpu + 1);
+    core_workers_active = true;
+    
+    for (int i = 0; i < config.num_cpu; i++) {
+        core_threads.emplace_back(&Scheduler::coreWorkerLoop, this, i);
+    }
+}
+
+void Scheduler::stopCoreWorkers() {
+    if (core_threads.empty()) {
+        return;
+    }
+    
+    // Release the workers from the start barrier with the stop flag cleared
+    core_workers_active = false;
+    tick_start_barrier.arriveAndWait();
+    
+    for (auto& thread : core_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    core_threads.clear();
+}
+
+void Scheduler::coreWorkerLoop(int core) {
+    while (true) {
+        tick_start_barrier.arriveAndWait();
+        if (!core_workers_active) {
+            break;
+        }
+        
+        (this->*step_core)(core);
+        tick_end_barrier.arriveAndWait();
+    }
 }
 
 void Scheduler::startProcessGeneration() {
-    if (!process_generation_active) {
+    // A replay only admits the processes the trace recorded
+    if (!process_generation_active && !isReplaying()) {
         process_generation_active = true;
-        process_generator_thread = std::thread(&Scheduler::processGeneratorLoop, this);
+        
+        // In fast tick mode the scheduler loop generates processes itself
+        if (!fast_ticks) {
+            process_generator_thread = std::thread(&Scheduler::processGeneratorLoop, this);
+        }
     }
 }
 
@@ -50,92 +172,234 @@ void Scheduler::stopProcessGeneration() {
     }
 }
 
+// Generates the program on the calling thread, outside scheduler_mutex;
+// only admission needs the lock
 Process* Scheduler::createProcess(const std::string& name) {
+    std::unique_ptr<Process> process = newProcess(name);
+    process->generateRandomInstructions(config.min_ins, config.max_ins, processSeed(master_seed, process->id));
+    
     std::lock_guard<std::mutex> lock(scheduler_mutex);
+    Process* process_ptr = admitProcess(std::move(process), TraceEvent::CREATE);
     
-    std::unique_ptr<Process> process(new Process(name));
-    process->generateRandomInstructions(config.min_ins, config.max_ins);
+    // A running scheduler publishes at the end of its next tick
+    if (!scheduler_running) {
+        publishStats();
+    }
     
+    return process_ptr;
+}
+
+std::unique_ptr<Process> Scheduler::newProcess(const std::string& name) {
+    std::unique_ptr<Process> process(new Process(name));
+    process->log.setCapacity(config.log_capacity);
+    return process;
+}
+
+// Hands a new batch process to the generator pool; the scheduler admits it
+// once its program is ready
+void Scheduler::submitGeneratedProcess() {
+    std::unique_ptr<Process> process = newProcess(generateProcessName());
+    uint64_t seed = processSeed(master_seed, process->id);
+    generator_pool.submit(std::move(process), seed);
+}
+
+// Caller holds scheduler_mutex
+Process* Scheduler::admitProcess(std::unique_ptr<Process> process, TraceEvent source) {
     Process* process_ptr = process.get();
-    all_processes.push_back(std::move(process));
+    process_ptr->memory_access = memory_manager->accessHandler();
+    all_processes[process_ptr->id] = std::move(process);
+    trace.record(cpu_ticks, source, -1, process_ptr->id, process_ptr->name);
+    process_ptr->arrival_tick = cpu_ticks;
+    process_ptr->ready_since_tick = cpu_ticks;
     
     // Try to allocate memory for the process
     if (memory_manager->allocateMemory(process_ptr)) {
         // Memory allocated successfully, add to ready queue
-        ready_queue.push(process_ptr);
+        trace.record(cpu_ticks, TraceEvent::MEMORY_ADMIT, -1, process_ptr->id);
+        memory_admissions++;
+        (this->*make_ready)(process_ptr, -1);
     } else {
         // No memory available, add to backing store
+        trace.record(cpu_ticks, TraceEvent::MEMORY_DEFER, -1, process_ptr->id);
+        memory_deferrals++;
         backing_store.push(process_ptr);
     }
+    addView(process_ptr);
     
     return process_ptr;
 }
 
-Process* Scheduler::findProcess(const std::string& name) {
+// Replay: rebuilds the processes the trace admitted at this point of the
+// tick, with their recorded ids so they get the same seeds and programs.
+// Caller holds scheduler_mutex.
+void Scheduler::admitRecordedProcesses(TraceEvent source) {
+    TraceRecord admission;
+    while (trace.nextAdmission(source, cpu_ticks, admission)) {
+        std::unique_ptr<Process> process(new Process(admission.name, admission.process_id));
+        process->log.setCapacity(config.log_capacity);
+        process->generateRandomInstructions(config.min_ins, config.max_ins, processSeed(master_seed, process->id));
+        admitProcess(std::move(process), source);
+    }
+}
+
+void Scheduler::printTraceStatus(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    trace.printStatus(out);
+}
+
+bool Scheduler::getProcessView(const std::string& name, ProcessView& view, ProcessLog* log) {
     std::lock_guard<std::mutex> lock(scheduler_mutex);
     
-    for (const auto& process : all_processes) {
+    for (const auto& entry : all_processes) {
+        Process* process = entry.second.get();
         if (process->name == name) {
-            return process.get();
+            view = process->view();
+            if (log) {
+                *log = process->log;
+            }
+            return true;
         }
     }
-    return nullptr;
+    return false;
 }
 
-std::vector<Process*> Scheduler::getAllProcesses() {
+bool Scheduler::getFinishedProcess(const std::string& name, ProcessRecord& record) {
     std::lock_guard<std::mutex> lock(scheduler_mutex);
-    std::vector<Process*> processes;
     
-    for (const auto& process : all_processes) {
-        processes.push_back(process.get());
+    auto it = finished_by_name.find(name);
+    if (it == finished_by_name.end()) {
+        return false;
     }
-    
-    return processes;
+    record = finished_processes[it->second];
+    return true;
 }
 
-std::vector<Process*> Scheduler::getRunningProcesses() {
-    std::lock_guard<std::mutex> lock(scheduler_mutex);
-    std::vector<Process*> processes;
-    
-    for (const auto& process : all_processes) {
-        if (process->state == ProcessState::RUNNING || 
-            process->state == ProcessState::READY || 
-            process->state == ProcessState::WAITING) {
-            processes.push_back(process.get());
-        }
+std::shared_ptr<const SchedulerStats> Scheduler::getStats() const {
+    std::shared_ptr<const SchedulerStats> stats = std::atomic_load(&published_stats);
+    if (!stats) {
+        static const std::shared_ptr<const SchedulerStats> empty = std::make_shared<SchedulerStats>();
+        return empty;
     }
-    
-    return processes;
+    return stats;
 }
 
-std::vector<Process*> Scheduler::getFinishedProcesses() {
-    std::lock_guard<std::mutex> lock(scheduler_mutex);
-    std::vector<Process*> processes;
-    
-    for (const auto& process : all_processes) {
-        if (process->state == ProcessState::FINISHED) {
-            processes.push_back(process.get());
-        }
+double Scheduler::getCPUUtilization() const {
+    return getStats()->cpuUtilization();
+}
+
+int Scheduler::getUsedCores() const {
+    return getStats()->used_cores;
+}
+
+int Scheduler::getAvailableCores() const {
+    return getStats()->availableCores();
+}
+
+// New processes go into the newest chunk, or a fresh one once it is full.
+// Caller holds scheduler_mutex.
+void Scheduler::addView(const Process* process) {
+    if (view_chunks.empty() || view_chunks.back().members.size() >= SchedulerStats::PROCESS_CHUNK) {
+        view_chunks.emplace_back();
+        view_chunks.back().members.reserve(SchedulerStats::PROCESS_CHUNK);
+        view_chunks.back().views.reserve(SchedulerStats::PROCESS_CHUNK);
     }
-    
-    return processes;
+    ViewChunkRef chunk = std::prev(view_chunks.end());
+    chunk->members.push_back(process);
+    chunk->views.push_back(process->view());
+    view_chunk_of[process] = chunk;
+    markViewChunk(chunk);
+}
+
+// Chunks are not merged as processes retire; a chunk goes away once empty
+void Scheduler::removeView(const Process* process) {
+    auto found = view_chunk_of.find(process);
+    if (found == view_chunk_of.end()) {
+        return;
+    }
+    ViewChunkRef chunk = found->second;
+    size_t index = std::find(chunk->members.begin(), chunk->members.end(), process) - chunk->members.begin();
+    chunk->members.erase(chunk->members.begin() + index);
+    chunk->views.erase(chunk->views.begin() + index);
+    view_chunk_of.erase(found);
+    markViewChunk(chunk);
 }
 
-double Scheduler::getCPUUtilization() {
-    int used_cores = getUsedCores();
-    return (static_cast<double>(used_cores) / config.num_cpu) * 100.0;
+void Scheduler::markViewChunk(ViewChunkRef chunk) {
+    if (!chunk->dirty) {
+        chunk->dirty = true;
+        dirty_view_chunks.push_back(chunk);
+    }
 }
 
-int Scheduler::getUsedCores() {
-    int used = 0;
-    for (bool busy : cpu_cores_busy) {
-        if (busy) used++;
+// Refreshes the views of the processes touched this tick and re-copies only
+// their chunks; every other chunk is shared with the previous snapshot
+void Scheduler::publishViews(SchedulerStats& stats) {
+    for (const Process* process : changed_views) {
+        auto found = view_chunk_of.find(process);
+        if (found == view_chunk_of.end()) {
+            continue; // Retired this tick
+        }
+        ViewChunkRef chunk = found->second;
+        size_t index = std::find(chunk->members.begin(), chunk->members.end(), process) - chunk->members.begin();
+        chunk->views[index] = process->view();
+        markViewChunk(chunk);
+    }
+    changed_views.clear();
+    
+    for (ViewChunkRef chunk : dirty_view_chunks) {
+        chunk->dirty = false;
+        if (chunk->members.empty()) {
+            view_chunks.erase(chunk);
+        } else {
+            chunk->published = std::make_shared<const SchedulerStats::ProcessChunk>(chunk->views);
+        }
     }
-    return used;
+    dirty_view_chunks.clear();
+    
+    stats.process_chunks.reserve(view_chunks.size());
+    for (const ViewChunk& chunk : view_chunks) {
+        stats.process_chunks.push_back(chunk.published);
+    }
+    stats.process_count = view_chunk_of.size();
 }
 
-int Scheduler::getAvailableCores() {
-    return config.num_cpu - getUsedCores();
+// Caller holds scheduler_mutex
+void Scheduler::publishStats() {
+    std::shared_ptr<SchedulerStats> stats = std::make_shared<SchedulerStats>();
+    stats->tick = cpu_ticks;
+    stats->num_cpu = config.num_cpu;
+    for (char busy : cpu_cores_busy) {
+        if (busy) stats->used_cores++;
+    }
+    
+    // Seal every full chunk once; the partial tail is re-copied only when
+    // more processes have finished since the last publish
+    const size_t chunk_size = SchedulerStats::FINISHED_CHUNK;
+    while ((sealed_finished.size() + 1) * chunk_size <= finished_processes.size()) {
+        auto first = finished_processes.begin() + sealed_finished.size() * chunk_size;
+        sealed_finished.push_back(std::make_shared<const SchedulerStats::FinishedChunk>(first, first + chunk_size));
+        finished_tail.reset();
+    }
+    size_t tail_start = sealed_finished.size() * chunk_size;
+    size_t tail_size = finished_processes.size() - tail_start;
+    if (tail_size > 0 && (!finished_tail || finished_tail->size() != tail_size)) {
+        auto first = finished_processes.begin() + tail_start;
+        finished_tail = std::make_shared<const SchedulerStats::FinishedChunk>(first, finished_processes.end());
+    }
+    stats->finished_chunks = sealed_finished;
+    if (tail_size > 0) {
+        stats->finished_chunks.push_back(finished_tail);
+    }
+    stats->finished_count = finished_processes.size();
+    publishViews(*stats);
+    stats->instructions_executed = instructions_executed;
+    stats->memory_admissions = memory_admissions;
+    stats->memory_deferrals = memory_deferrals;
+    stats->turnaround_sum = turnaround_sum;
+    stats->waiting_sum = waiting_sum;
+    stats->fragmentation_sum = fragmentation_sum;
+    
+    std::atomic_store(&published_stats, std::shared_ptr<const SchedulerStats>(std::move(stats)));
 }
 
 int Scheduler::getProcessesInMemory() const {
@@ -146,27 +410,126 @@ size_t Scheduler::getTotalExternalFragmentation() const {
     return memory_manager->getTotalExternalFragmentation();
 }
 
+void Scheduler::printMemoryStats(std::ostream& out) const {
+    memory_manager->printStats(out);
+}
+
 void Scheduler::schedulerLoop() {
     while (scheduler_running) {
-        cpu_ticks++;
+        if (trace.replayDone(cpu_ticks)) {
+            // Replay finished; keep the final state up for the CLI
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        
+        runTick();
         
-        {
-            std::lock_guard<std::mutex> lock(scheduler_mutex);
-            manageMemory();
-            scheduleProcess();
-            executeProcesses();
+        if (!fast_ticks) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    }
+}
+
+// Runs the ticks back-to-back on the calling thread with process generation
+// on, then stops everything it started. For headless benchmarks; the
+// scheduler thread must not be running.
+void Scheduler::runTicks(long long ticks) {
+    config.tick_mode = "fast";
+    fast_ticks = true;
+    snapshot_writer.start();
+    generator_pool.start(config.generator_threads, config.min_ins, config.max_ins);
+    if (config.exec_mode == "parallel") {
+        startCoreWorkers();
+    }
+    process_generation_active = true;
+    
+    for (long long i = 0; i < ticks; i++) {
+        runTick();
+    }
+    
+    process_generation_active = false;
+    stopCoreWorkers();
+    generator_pool.stop();
+    snapshot_writer.stop();
+    
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+    publishStats();
+}
+
+template <class Policy>
+void Scheduler::runTickWith() {
+    Policy& policy = std::get<Policy>(policies);
+    
+    const TickProfiler::Clock::time_point tick_start = profiler.startTick();
+    
+    // Fast mode admits exactly one process every batch_process_freq
+    // ticks, waiting for it if needed, so a fixed seed replays the same
+    // run. The pool works a few processes ahead to make that wait rare.
+    std::unique_ptr<Process> due_process;
+    if (fast_ticks && process_generation_active) {
+        const uint64_t generation_lookahead = static_cast<uint64_t>(std::max(2, 2 * config.generator_threads));
+        while (generator_pool.outstanding() < generation_lookahead) {
+            submitGeneratedProcess();
         }
+        generation_tick_count++;
+        if (generation_tick_count >= config.batch_process_freq) {
+            due_process = generator_pool.take();
+            generation_tick_count = 0;
+        }
+    }
+    TickProfiler::Clock::time_point lap = profiler.lap(TickPhase::GENERATE, tick_start);
+    
+    bool take_snapshot = false;
+    MemorySnapshot snapshot;
+    
+    {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        lap = profiler.lap(TickPhase::LOCK, lap);
+        // Ticks advance under the lock so a trace places every
+        // admission from screen -s unambiguously between two ticks
+        cpu_ticks++;
+        admitRecordedProcesses(TraceEvent::ADMIT);
+        if (due_process) {
+            admitProcess(std::move(due_process));
+        } else if (!fast_ticks) {
+            // Realtime mode admits whatever the pool has finished, in order
+            while (std::unique_ptr<Process> process = generator_pool.tryTake()) {
+                admitProcess(std::move(process));
+            }
+        }
+        lap = profiler.lap(TickPhase::ADMIT, lap);
+        manageMemory();
+        lap = profiler.lap(TickPhase::MEMORY, lap);
+        scheduleProcess(policy);
+        lap = profiler.lap(TickPhase::SCHEDULE, lap);
+        executeProcesses(policy);
+        lap = profiler.lap(TickPhase::EXECUTE, lap);
+        retireFinishedProcesses();
+        admitRecordedProcesses(TraceEvent::CREATE);
+        lap = profiler.lap(TickPhase::RETIRE, lap);
+        fragmentation_sum += memory_manager->getTotalExternalFragmentation();
+        publishStats();
+        if (trace.replayDone(cpu_ticks)) {
+            trace.finish(cpu_ticks);
+        }
+        lap = profiler.lap(TickPhase::PUBLISH, lap);
         
-        // generate memory snapshot every quantum cycle only
+        // capture memory snapshot every quantum cycle only
         if (cpu_ticks % config.quantum_cycles == 0) {
             // check: only create snapshot if there are processes in memory
             if (process_generation_active || memory_manager->getProcessesInMemory() > 0) {
-                memory_manager->generateMemorySnapshot();
+                snapshot = memory_manager->captureSnapshot(cpu_ticks);
+                take_snapshot = true;
             }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+    
+    // Formatting and disk I/O happen on the snapshot writer thread
+    if (take_snapshot) {
+        snapshot_writer.submit(std::move(snapshot));
+    }
+    TickProfiler::Clock::time_point tick_end = profiler.lap(TickPhase::SNAPSHOT, lap);
+    profiler.record(TickPhase::TICK, tick_start, tick_end);
 }
 
 void Scheduler::processGeneratorLoop() {
@@ -176,8 +539,7 @@ void Scheduler::processGeneratorLoop() {
         tick_count++;
         
         if (tick_count >= config.batch_process_freq) {
-            std::string process_name = generateProcessName();
-            createProcess(process_name);
+            submitGeneratedProcess();
             tick_count = 0;
         }
         
@@ -185,22 +547,36 @@ void Scheduler::processGeneratorLoop() {
     }
 }
 
-void Scheduler::manageMemory() {
-    // Check if any processes have finished and can be removed from memory
-    for (const auto& process_ptr : all_processes) {
-        Process* process = process_ptr.get();
-        if (process->state == ProcessState::FINISHED) {
-            memory_manager->deallocateMemory(process);
-        }
+// Free the memory of processes that finished this tick and move them out of
+// the live set into the compact archive
+void Scheduler::retireFinishedProcesses() {
+    for (Process* process : finished_this_tick) {
+        memory_manager->deallocateMemory(process);
+        trace.record(cpu_ticks, TraceEvent::MEMORY_FREE, -1, process->id);
+        process->releaseProgram();
+        
+        finished_by_name[process->name] = finished_processes.size();
+        finished_processes.push_back(process->toRecord());
+        finished_processes.back().finish_tick = cpu_ticks;
+        turnaround_sum += cpu_ticks - process->arrival_tick;
+        waiting_sum += process->waiting_ticks;
+        removeView(process);
+        all_processes.erase(process->id);
     }
-    
+    finished_this_tick.clear();
+}
+
+void Scheduler::manageMemory() {
     // Try to move processes from backing store to memory
     while (!backing_store.empty() && memory_manager->hasAvailableMemory()) {
         Process* process = backing_store.front();
         backing_store.pop();
         
         if (memory_manager->allocateMemory(process)) {
-            ready_queue.push(process);
+            touchView(process);
+            trace.record(cpu_ticks, TraceEvent::MEMORY_ADMIT, -1, process->id);
+            memory_admissions++;
+            (this->*make_ready)(process, -1);
         } else {
             // Still no memory, put back in backing store
             backing_store.push(process);
@@ -209,110 +585,189 @@ void Scheduler::manageMemory() {
     }
 }
 
-void Scheduler::scheduleProcess() {
-    if (config.scheduler == "fcfs") {
-        // First Come First Serve
-        while (!ready_queue.empty()) {
-            bool scheduled = false;
-            for (int i = 0; i < config.num_cpu; i++) {
-                if (!cpu_cores_busy[i]) {
-                    Process* process = ready_queue.front();
-                    ready_queue.pop();
-                    
-                    process->state = ProcessState::RUNNING;
-                    process->cpu_core_assigned = i;
-                    running_processes[i] = process;
-                    cpu_cores_busy[i] = true;
-                    scheduled = true;
-                    break;
-                }
-            }
-            if (!scheduled) break;
+template <class Policy>
+void Scheduler::scheduleProcess(Policy& policy) {
+    policy.onTick(cpu_ticks, all_processes);
+    
+    // In parallel mode every core worker dispatches for itself in stepCore()
+    if (!central_dispatch) {
+        return;
+    }
+    
+    for (int i = 0; i < config.num_cpu && !policy.empty(); i++) {
+        if (!cpu_cores_busy[i] && !dispatchCore(policy, i)) {
+            break;
         }
-    } else if (config.scheduler == "rr") {
-        // Round Robin
-        while (!ready_queue.empty()) {
-            bool scheduled = false;
-            for (int i = 0; i < config.num_cpu; i++) {
-                if (!cpu_cores_busy[i]) {
-                    Process* process = ready_queue.front();
-                    ready_queue.pop();
-                    
-                    process->state = ProcessState::RUNNING;
-                    process->cpu_core_assigned = i;
-                    running_processes[i] = process;
-                    cpu_cores_busy[i] = true;
-                    process_time_slice[i] = config.quantum_cycles;
-                    scheduled = true;
-                    break;
-                }
-            }
-            if (!scheduled) break;
+    }
+}
+
+// Take the next ready process for an idle core; the policy decides which,
+// and for how long
+template <class Policy>
+bool Scheduler::dispatchCore(Policy& policy, int core) {
+    Process* process = policy.pickNext(core);
+    if (!process) {
+        return false;
+    }
+    
+    trace.record(cpu_ticks, TraceEvent::DISPATCH, core, process->id);
+    process->waiting_ticks += cpu_ticks - process->ready_since_tick;
+    process->state = ProcessState::RUNNING;
+    process->cpu_core_assigned = core;
+    running_processes[core] = process;
+    cpu_cores_busy[core] = 1;
+    process_time_slice[core] = policy.onDispatch(process);
+    return true;
+}
+
+template <class Policy>
+void Scheduler::executeProcesses(Policy& policy) {
+    // First, wake the sleeping processes that are due this tick
+    sleep_timers.advance(cpu_ticks, [this, &policy](Process* process) {
+        trace.record(cpu_ticks, TraceEvent::WAKE, -1, process->id);
+        process->ready_since_tick = cpu_ticks;
+        process->state = ProcessState::READY;
+        policy.push(process, process->last_core_assigned);
+        touchView(process);
+    });
+    
+    // Then run one instruction on every busy core. In parallel mode each core
+    // steps on its own worker thread; the scheduler thread waits at the barrier.
+    if (!core_threads.empty()) {
+        tick_start_barrier.arriveAndWait();
+        tick_end_barrier.arriveAndWait();
+    } else {
+        for (int i = 0; i < config.num_cpu; i++) {
+            stepCore<Policy>(i);
         }
     }
+    
+    // Queue and core bookkeeping stays on the scheduler thread, in core order
+    for (int i = 0; i < config.num_cpu; i++) {
+        retireCore(policy, i);
+    }
+    if (Policy::PREEMPTS_RUNNING) {
+        preemptRunning(policy);
+    }
 }
 
-void Scheduler::executeProcesses() {
-    // First, handle all sleeping processes (not assigned to cores)
-    for (const auto& process_ptr : all_processes) {
-        Process* process = process_ptr.get();
-        if (process->state == ProcessState::WAITING && process->sleep_ticks_remaining > 0) {
-            process->sleep_ticks_remaining--;
-            if (process->sleep_ticks_remaining == 0) {
-                process->state = ProcessState::READY;
-                ready_queue.push(process);
-            }
+template <class Policy>
+void Scheduler::stepCore(int core) {
+    core_stepped[core] = 0;
+    
+    if (!central_dispatch && !cpu_cores_busy[core]) {
+        dispatchCore(std::get<Policy>(policies), core);
+    }
+    
+    if (cpu_cores_busy[core] && running_processes[core]) {
+        Process* process = running_processes[core];
+        
+        if (process->state == ProcessState::RUNNING) {
+            core_continuing[core] = process->executeNextInstruction(config.delays_per_exec, cpu_ticks);
+            core_stepped[core] = 1;
         }
     }
+}
+
+template <class Policy>
+void Scheduler::retireCore(Policy& policy, int i) {
+    if (!core_stepped[i]) {
+        return;
+    }
+    
+    Process* process = running_processes[i];
+    bool continuing = core_continuing[i] != 0;
+    instructions_executed++;
+    touchView(process); // Covers its dispatch this tick too
     
-    // Then handle processes running on CPU cores
+    // Handle the time quantum; a time slice of 0 runs until sleep or finish
+    if (process_time_slice[i] > 0 && process->state == ProcessState::RUNNING) {
+        process_time_slice[i]--;
+        
+        // Time quantum expired - preempt the process
+        if (process_time_slice[i] <= 0 && continuing && process->state == ProcessState::RUNNING) {
+            preemptCore(policy, i, true);
+            return;
+        }
+    }
+    
+    if (!continuing || process->state == ProcessState::FINISHED) {
+        // CLEAR CORE ASSIGNMENT when process finishes
+        if (process->state == ProcessState::FINISHED) {
+            trace.record(cpu_ticks, TraceEvent::FINISH, i, process->id);
+            process->last_core_assigned = i;
+            process->cpu_core_assigned = -1;
+            policy.onFinish(process);
+            // Memory is freed and the process archived in retireFinishedProcesses()
+            finished_this_tick.push_back(process);
+        }
+        running_processes[i] = nullptr;
+        cpu_cores_busy[i] = 0;
+        process_time_slice[i] = 0;
+    } else if (process->state == ProcessState::WAITING) {
+        // Process went to sleep, remove from CPU until its wake tick
+        trace.record(cpu_ticks, TraceEvent::SLEEP, i, process->id);
+        process->wake_tick = cpu_ticks + process->sleep_ticks_requested;
+        sleep_timers.schedule(process, process->wake_tick);
+        policy.onSleep(process);
+        
+        // CLEAR CORE ASSIGNMENT when going to sleep
+        process->last_core_assigned = i;
+        process->cpu_core_assigned = -1;
+        running_processes[i] = nullptr;
+        cpu_cores_busy[i] = 0;
+        process_time_slice[i] = 0;
+    }
+}
+
+// Preemptive policies: waiting processes the policy ranks above a running
+// one take its core at the next dispatch. Idle cores are used first, then the
+// running processes the policy would give up first are preempted.
+template <class Policy>
+void Scheduler::preemptRunning(Policy& policy) {
+    int free_cores = 0;
     for (int i = 0; i < config.num_cpu; i++) {
-        if (cpu_cores_busy[i] && running_processes[i]) {
+        if (!cpu_cores_busy[i]) {
+            free_cores++;
+        }
+    }
+    
+    while (true) {
+        int victim = -1;
+        for (int i = 0; i < config.num_cpu; i++) {
             Process* process = running_processes[i];
-            
-            if (process->state == ProcessState::RUNNING) {
-                bool continuing = process->executeNextInstruction(config.delays_per_exec);
-                
-                // Handle Round Robin time quantum
-                if (config.scheduler == "rr" && process->state == ProcessState::RUNNING) {
-                    process_time_slice[i]--;
-                    
-                    // Time quantum expired - preempt the process
-                    if (process_time_slice[i] <= 0 && continuing && process->state == ProcessState::RUNNING) {
-                        process->state = ProcessState::READY;
-                        ready_queue.push(process);
-                        
-                        // CLEAR CORE ASSIGNMENT when preempting
-                        process->cpu_core_assigned = -1;
-                        running_processes[i] = nullptr;
-                        cpu_cores_busy[i] = false;
-                        process_time_slice[i] = 0;
-                        continue; // Skip the rest of the processing for this core
-                    }
-                }
-                
-                if (!continuing || process->state == ProcessState::FINISHED) {
-                    // CLEAR CORE ASSIGNMENT when process finishes
-                    if (process->state == ProcessState::FINISHED) {
-                        process->cpu_core_assigned = -1;
-                        // Memory will be deallocated in manageMemory()
-                    }
-                    running_processes[i] = nullptr;
-                    cpu_cores_busy[i] = false;
-                    process_time_slice[i] = 0;
-                } else if (process->state == ProcessState::WAITING) {
-                    // Process went to sleep, remove from CPU
-                    // CLEAR CORE ASSIGNMENT when going to sleep
-                    process->cpu_core_assigned = -1;
-                    running_processes[i] = nullptr;
-                    cpu_cores_busy[i] = false;
-                    process_time_slice[i] = 0;
-                }
+            if (cpu_cores_busy[i] && process && process->state == ProcessState::RUNNING &&
+                (victim < 0 || policy.preemptionRank(process) > policy.preemptionRank(running_processes[victim]))) {
+                victim = i;
             }
         }
+        if (victim < 0 || !policy.shouldPreempt(running_processes[victim], free_cores)) {
+            return;
+        }
+        preemptCore(policy, victim, false);
+        free_cores++;
     }
 }
 
+// Puts the core's running process back on the ready queue
+template <class Policy>
+void Scheduler::preemptCore(Policy& policy, int i, bool quantum_expired) {
+    Process* process = running_processes[i];
+    trace.record(cpu_ticks, TraceEvent::PREEMPT, i, process->id);
+    process->ready_since_tick = cpu_ticks;
+    process->state = ProcessState::READY;
+    touchView(process);
+    policy.onPreempt(process, quantum_expired);
+    policy.push(process, i);
+    
+    // CLEAR CORE ASSIGNMENT when preempting
+    process->last_core_assigned = i;
+    process->cpu_core_assigned = -1;
+    running_processes[i] = nullptr;
+    cpu_cores_busy[i] = 0;
+    process_time_slice[i] = 0;
+}
+
 std::string Scheduler::generateProcessName() {
     std::string name = "process" + std::to_string(process_counter);
     process_counter++;
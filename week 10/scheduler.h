@@ -4,33 +4,109 @@
 #include <vector>
 #include <memory>
 #include <queue>
+#include <list>
+#include <map>
+#include <unordered_map>
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <tuple>
 #include "process.h"
 #include "config.h"
 #include "memory_manager.h"
+#include "paged_memory_manager.h"
+#include "snapshot_writer.h"
+#include "tick_barrier.h"
+#include "scheduling_policy.h"
+#include "timer_wheel.h"
+#include "scheduler_stats.h"
+#include "generator_pool.h"
+#include "scheduler_trace.h"
+#include "tick_profiler.h"
 
 class Scheduler {
 private:
     Config config;
-    std::vector<std::unique_ptr<Process>> all_processes;
-    std::queue<Process*> ready_queue;
+    ProcessTable all_processes; // Live processes by id
+    std::vector<ProcessRecord> finished_processes; // Archive of retired processes
+    std::unordered_map<std::string, size_t> finished_by_name;
+    std::vector<Process*> finished_this_tick;
+    TimerWheel<Process*> sleep_timers; // WAITING processes keyed by wake tick
+    
+    // One instance of every policy; config.scheduler picks the one the tick
+    // loop is instantiated with. Each policy owns its ready queue.
+    std::tuple<FcfsPolicy, RoundRobinPolicy, MlfqPolicy, SjfPolicy, SrtfPolicy> policies;
+    void (Scheduler::*tick_loop)() = nullptr; // runTickWith<Policy>
+    void (Scheduler::*step_core)(int) = nullptr; // stepCore<Policy>, for core workers
+    void (Scheduler::*make_ready)(Process*, int) = nullptr; // makeReady<Policy>
     std::vector<Process*> running_processes;
-    std::vector<bool> cpu_cores_busy;
+    std::vector<char> cpu_cores_busy; // char, not bool: written per core from worker threads
     std::vector<int> process_time_slice; // Time slice remaining for each core
+    std::vector<char> core_continuing; // Result of each core's step this tick
+    std::vector<char> core_stepped;
     std::atomic<bool> scheduler_running{false};
     std::atomic<bool> process_generation_active{false};
     std::atomic<long long> cpu_ticks{0};
     std::mutex scheduler_mutex;
     std::thread scheduler_thread;
     std::thread process_generator_thread;
+    
+    // Parallel execution: one worker thread per core, synchronized per tick
+    std::vector<std::thread> core_threads;
+    std::atomic<bool> core_workers_active{false};
+    TickBarrier tick_start_barrier;
+    TickBarrier tick_end_barrier;
     int process_counter = 1;
     int next_process_id = 1;
+    int generation_tick_count = 0;
+    uint64_t master_seed = 0; // Every process seed is derived from this
+    GeneratorPool generator_pool;
+    
+    // Trace recording and replay. Both need dispatch in core order on the
+    // scheduler thread, so parallel workers only execute while tracing.
+    SchedulerTrace trace;
+    bool central_dispatch = true;
+    
+    // Fast mode runs ticks back-to-back and drives process generation from
+    // the tick counter instead of the wall-clock generator thread. Resolved
+    // from config.tick_mode once, not per tick.
+    bool fast_ticks = false;
     
     // Memory management
-    std::unique_ptr<MemoryManager> memory_manager;
+    std::unique_ptr<MemoryBackend> memory_manager;
     std::queue<Process*> backing_store; // Processes waiting for memory
+    SnapshotWriter snapshot_writer; // Appends per-quantum snapshots off the tick path
+    
+    // Read-only stats for the CLI, swapped in atomically after each tick
+    std::shared_ptr<const SchedulerStats> published_stats;
+    std::vector<std::shared_ptr<const SchedulerStats::FinishedChunk>> sealed_finished;
+    std::shared_ptr<const SchedulerStats::FinishedChunk> finished_tail;
+    
+    // Views of the live processes, in chunks of SchedulerStats::PROCESS_CHUNK
+    // by admission order. Processes that change during a tick are noted in
+    // changed_views; publishStats() refreshes only those views and copies
+    // only the chunks they are in.
+    struct ViewChunk {
+        std::vector<const Process*> members;
+        std::vector<ProcessView> views; // Same order as members
+        std::shared_ptr<const SchedulerStats::ProcessChunk> published;
+        bool dirty = false;
+    };
+    typedef std::list<ViewChunk>::iterator ViewChunkRef;
+    std::list<ViewChunk> view_chunks;
+    std::unordered_map<const Process*, ViewChunkRef> view_chunk_of;
+    std::vector<const Process*> changed_views; // May repeat, or name retired processes
+    std::vector<ViewChunkRef> dirty_view_chunks;
+    
+    // Run totals for benchmarks, published with the stats
+    long long instructions_executed = 0;
+    long long memory_admissions = 0;
+    long long memory_deferrals = 0;
+    long long turnaround_sum = 0;
+    long long waiting_sum = 0;
+    long long fragmentation_sum = 0; // External fragmentation (KB) summed over ticks
+    
+    TickProfiler profiler; // Per-phase tick latencies for report-perf
     
 public:
     Scheduler() = default;
@@ -39,28 +115,58 @@ public:
     void initialize(const Config& cfg);
     void startScheduler();
     void stopScheduler();
+    void runTicks(long long ticks);
     void startProcessGeneration();
     void stopProcessGeneration();
     Process* createProcess(const std::string& name);
-    Process* findProcess(const std::string& name);
-    std::vector<Process*> getAllProcesses();
-    std::vector<Process*> getRunningProcesses();
-    std::vector<Process*> getFinishedProcesses();
-    double getCPUUtilization();
-    int getUsedCores();
-    int getAvailableCores();
+    bool getProcessView(const std::string& name, ProcessView& view, ProcessLog* log = nullptr);
+    bool getFinishedProcess(const std::string& name, ProcessRecord& record);
+    std::shared_ptr<const SchedulerStats> getStats() const;
+    double getCPUUtilization() const;
+    int getUsedCores() const;
+    int getAvailableCores() const;
     long long getCurrentTicks() { return cpu_ticks; }
+    uint64_t getMasterSeed() const { return master_seed; }
+    bool isReplaying() const { return trace.getMode() == SchedulerTrace::Mode::REPLAY; }
+    void printTraceStatus(std::ostream& out);
+    const TickProfiler& getProfiler() const { return profiler; }
+    void resetProfiler() { profiler.requestReset(); }
+    const std::vector<int>& getLevelQuantums() const { return std::get<MlfqPolicy>(policies).levelQuantums(); }
     
     // Memory management methods
     int getProcessesInMemory() const;
     size_t getTotalExternalFragmentation() const;
+    void printMemoryStats(std::ostream& out) const;
     
 private:
     void schedulerLoop();
+    void runTick() { (this->*tick_loop)(); }
     void processGeneratorLoop();
-    void scheduleProcess();
-    void executeProcesses();
+    template <class Policy> void usePolicy();
+    template <class Policy> void runTickWith();
+    template <class Policy> void scheduleProcess(Policy& policy);
+    template <class Policy> bool dispatchCore(Policy& policy, int core);
+    template <class Policy> void executeProcesses(Policy& policy);
+    template <class Policy> void stepCore(int core);
+    template <class Policy> void retireCore(Policy& policy, int core);
+    template <class Policy> void preemptRunning(Policy& policy);
+    template <class Policy> void preemptCore(Policy& policy, int core, bool quantum_expired);
+    template <class Policy> void makeReady(Process* process, int core);
+    void coreWorkerLoop(int core);
+    void startCoreWorkers();
+    void stopCoreWorkers();
     void manageMemory();
+    void retireFinishedProcesses();
+    std::unique_ptr<Process> newProcess(const std::string& name);
+    void submitGeneratedProcess();
+    Process* admitProcess(std::unique_ptr<Process> process, TraceEvent source = TraceEvent::ADMIT);
+    void admitRecordedProcesses(TraceEvent source);
+    void publishStats();
+    void addView(const Process* process);
+    void touchView(const Process* process) { changed_views.push_back(process); }
+    void removeView(const Process* process);
+    void markViewChunk(ViewChunkRef chunk);
+    void publishViews(SchedulerStats& stats);
     std::string generateProcessName();
 };
 
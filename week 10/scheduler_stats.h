@@ -0,0 +1,81 @@
+#ifndef SCHEDULER_STATS_H
+#define SCHEDULER_STATS_H
+
+#include <vector>
+#include <memory>
+#include "process.h"
+
+// Immutable picture of the scheduler, published once per tick. Readers load
+// the current pointer and keep it for as long as they print, so the CLI
+// never touches a live Process.
+struct SchedulerStats {
+    // Finished records are shared in sealed chunks; only the newest,
+    // partially filled chunk is copied when a snapshot is published
+    static const size_t FINISHED_CHUNK = 256;
+    typedef std::vector<ProcessRecord> FinishedChunk;
+    
+    // Live process views are shared in chunks too; a chunk is copied only
+    // when one of its processes changed since the last publish
+    static const size_t PROCESS_CHUNK = 64;
+    typedef std::vector<ProcessView> ProcessChunk;
+    
+    long long tick = 0;
+    int num_cpu = 0;
+    int used_cores = 0;
+    std::vector<std::shared_ptr<const ProcessChunk>> process_chunks; // Live processes, by admission
+    size_t process_count = 0;
+    std::vector<std::shared_ptr<const FinishedChunk>> finished_chunks;
+    size_t finished_count = 0;
+    
+    // Run totals; turnaround and waiting cover finished processes, in ticks
+    long long instructions_executed = 0;
+    long long memory_admissions = 0;  // Includes processes let in from the backing store
+    long long memory_deferrals = 0;   // Admitted to the backing store first
+    long long turnaround_sum = 0;
+    long long waiting_sum = 0;        // Waiting for memory or a core
+    long long fragmentation_sum = 0;  // External fragmentation (KB) summed over ticks
+    
+    size_t processCount() const {
+        return process_count;
+    }
+    
+    double cpuUtilization() const {
+        return num_cpu > 0 ? (static_cast<double>(used_cores) / num_cpu) * 100.0 : 0.0;
+    }
+    
+    int availableCores() const {
+        return num_cpu - used_cores;
+    }
+    
+    double averageTurnaround() const {
+        return finished_count > 0 ? static_cast<double>(turnaround_sum) / finished_count : 0.0;
+    }
+    
+    double averageWaiting() const {
+        return finished_count > 0 ? static_cast<double>(waiting_sum) / finished_count : 0.0;
+    }
+    
+    double averageFragmentation() const {
+        return tick > 0 ? static_cast<double>(fragmentation_sum) / tick : 0.0;
+    }
+    
+    template <typename Visitor>
+    void forEachProcess(Visitor visit) const {
+        for (const auto& chunk : process_chunks) {
+            for (const ProcessView& view : *chunk) {
+                visit(view);
+            }
+        }
+    }
+    
+    template <typename Visitor>
+    void forEachFinished(Visitor visit) const {
+        for (const auto& chunk : finished_chunks) {
+            for (const ProcessRecord& record : *chunk) {
+                visit(record);
+            }
+        }
+    }
+};
+
+#endif
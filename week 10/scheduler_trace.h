@@ -0,0 +1,361 @@
+#ifndef SCHEDULER_TRACE_H
+#define SCHEDULER_TRACE_H
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <cstdint>
+#include "snapshot_codec.h"
+
+// Scheduling decisions, in the order the scheduler makes them. ADMIT is a
+// batch process taken in at the start of a tick, CREATE one made with
+// screen -s between ticks.
+enum class TraceEvent : uint8_t {
+    ADMIT,
+    CREATE,
+    MEMORY_ADMIT, // Got memory and went on the ready queue
+    MEMORY_DEFER, // Parked in the backing store
+    MEMORY_FREE,  // Finished and released its memory
+    DISPATCH,
+    PREEMPT,
+    SLEEP,
+    WAKE,
+    FINISH,
+    END           // Last tick of the recording
+};
+
+struct TraceRecord {
+    long long tick = 0;
+    TraceEvent event = TraceEvent::END;
+    int core = -1;
+    int process_id = 0;
+    std::string name; // ADMIT and CREATE only
+};
+
+inline const char* traceEventName(TraceEvent event) {
+    switch (event) {
+        case TraceEvent::ADMIT: return "admit";
+        case TraceEvent::CREATE: return "create";
+        case TraceEvent::MEMORY_ADMIT: return "memory-admit";
+        case TraceEvent::MEMORY_DEFER: return "memory-defer";
+        case TraceEvent::MEMORY_FREE: return "memory-free";
+        case TraceEvent::DISPATCH: return "dispatch";
+        case TraceEvent::PREEMPT: return "preempt";
+        case TraceEvent::SLEEP: return "sleep";
+        case TraceEvent::WAKE: return "wake";
+        case TraceEvent::FINISH: return "finish";
+        case TraceEvent::END: return "end";
+    }
+    return "?";
+}
+
+inline std::string formatTraceRecord(const TraceRecord& record) {
+    std::ostringstream line;
+    line << "(tick " << record.tick << ") " << traceEventName(record.event);
+    if (record.event != TraceEvent::END) {
+        line << " process " << record.process_id;
+    }
+    if (!record.name.empty()) {
+        line << " \"" << record.name << "\"";
+    }
+    if (record.core >= 0) {
+        line << " core " << record.core;
+    }
+    return line.str();
+}
+
+// Trace file (trace-file in config.txt)
+//
+//   file   := "CTRC" version:u8 master_seed config_length config_text event*
+//   event  := tick_delta type:u8 core process_id name?
+//
+// Numbers are varints from snapshot_codec.h; core is stored as core + 1 so
+// -1 fits, and only ADMIT and CREATE carry a length-prefixed name. The config
+// text is in config.txt format, so a replay runs with the recorded settings.
+//
+// Recording appends every event to a buffer that is written out in blocks.
+// Replaying reads the whole file and walks it with two cursors: one feeds the
+// recorded admissions back into the scheduler, the other checks each event
+// the scheduler makes against the recording and stops at the first mismatch.
+class SchedulerTrace {
+public:
+    enum class Mode { OFF, RECORD, REPLAY };
+    
+private:
+    static const char* magic() { return "CTRC"; }
+    static const uint8_t VERSION = 1;
+    static const size_t FLUSH_BYTES = 64 * 1024;
+    
+    // Decodes events one at a time from a position in the loaded file
+    struct Cursor {
+        size_t pos = 0;
+        long long tick = 0;
+        bool has_record = false;
+        TraceRecord record; // Next undelivered event, once has_record
+    };
+    
+    Mode mode = Mode::OFF;
+    std::string path;
+    std::string error; // Why recording or replay could not start
+    std::ofstream file;
+    std::string buffer; // RECORD: bytes not written yet, REPLAY: the whole file
+    long long last_tick = 0;
+    long long events = 0;
+    
+    // Replay state
+    size_t events_start = 0;
+    Cursor expected;
+    Cursor admissions;
+    long long end_tick = -1;
+    bool has_end = false;
+    long long matched = 0;
+    bool diverged = false;
+    bool finished = false;
+    std::string divergence;
+    
+public:
+    ~SchedulerTrace() { finish(last_tick); }
+    
+    Mode getMode() const { return mode; }
+    const std::string& getPath() const { return path; }
+    
+    // Reads only the header: the seed and config a trace was recorded with
+    static bool readHeader(const std::string& trace_path, uint64_t& seed, std::string& config_text) {
+        std::ifstream in(trace_path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        size_t pos = 0;
+        return in.is_open() && parseHeader(data, pos, seed, config_text);
+    }
+    
+    bool startRecording(const std::string& trace_path, uint64_t seed, const std::string& config_text) {
+        path = trace_path;
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error = "could not open " + path + " for writing";
+            return false;
+        }
+        buffer.append(magic(), 4);
+        buffer.push_back(static_cast<char>(VERSION));
+        snapshot_codec::putVarint(buffer, seed);
+        snapshot_codec::putVarint(buffer, config_text.size());
+        buffer += config_text;
+        mode = Mode::RECORD;
+        return true;
+    }
+    
+    bool startReplay(const std::string& trace_path) {
+        path = trace_path;
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            error = "could not read " + path;
+            return false;
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        
+        uint64_t seed;
+        std::string config_text;
+        size_t pos = 0;
+        if (!parseHeader(buffer, pos, seed, config_text)) {
+            error = path + " is not a scheduler trace";
+            buffer.clear();
+            return false;
+        }
+        events_start = pos;
+        
+        // Find the end tick up front so the replay knows when to stop. A
+        // trace cut short (no END) replays up to its last event.
+        Cursor scan;
+        scan.pos = events_start;
+        while (peek(scan)) {
+            events++;
+            end_tick = scan.record.tick;
+            has_end = scan.record.event == TraceEvent::END;
+            scan.has_record = false;
+        }
+        
+        expected.pos = events_start;
+        admissions.pos = events_start;
+        mode = Mode::REPLAY;
+        return true;
+    }
+    
+    // Caller holds scheduler_mutex
+    void record(long long tick, TraceEvent event, int core, int process_id) {
+        if (mode != Mode::OFF) {
+            record(tick, event, core, process_id, std::string());
+        }
+    }
+    
+    void record(long long tick, TraceEvent event, int core, int process_id, const std::string& name) {
+        if (mode == Mode::RECORD) {
+            append(tick, event, core, process_id, name);
+        } else if (mode == Mode::REPLAY && !diverged && !finished) {
+            TraceRecord actual;
+            actual.tick = tick;
+            actual.event = event;
+            actual.core = core;
+            actual.process_id = process_id;
+            actual.name = name;
+            check(actual);
+        }
+    }
+    
+    // REPLAY: the next recorded admission of the given kind that is due by
+    // this tick, if it is also the next admission in the recording
+    bool nextAdmission(TraceEvent kind, long long tick, TraceRecord& admission) {
+        // While recording, buffer holds unwritten output, not events to replay
+        if (mode != Mode::REPLAY) {
+            return false;
+        }
+        while (peek(admissions)) {
+            TraceEvent event = admissions.record.event;
+            if (event == TraceEvent::ADMIT || event == TraceEvent::CREATE) {
+                if (event != kind || admissions.record.tick > tick) {
+                    return false;
+                }
+                admission = admissions.record;
+                admissions.has_record = false;
+                return true;
+            }
+            admissions.has_record = false;
+        }
+        return false;
+    }
+    
+    // REPLAY: true once the last recorded tick has run
+    bool replayDone(long long tick) const {
+        return mode == Mode::REPLAY && (finished || end_tick < 0 || tick >= end_tick);
+    }
+    
+    // RECORD: writes the END event and closes the file. REPLAY: checks that
+    // nothing recorded is left over.
+    void finish(long long tick) {
+        if (mode == Mode::RECORD && file.is_open()) {
+            append(tick, TraceEvent::END, -1, 0, "");
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+            file.close();
+        } else if (mode == Mode::REPLAY && !finished) {
+            if (!diverged && has_end) {
+                TraceRecord end;
+                end.tick = tick;
+                check(end);
+            }
+            finished = true;
+        }
+    }
+    
+    void printStatus(std::ostream& out) const {
+        switch (mode) {
+            case Mode::OFF:
+                out << "Trace: " << (error.empty() ? "off" : error) << "\n";
+                break;
+            case Mode::RECORD:
+                out << "Trace: recording to " << path << " (" << events << " events)\n";
+                break;
+            case Mode::REPLAY:
+                out << "Trace: replaying " << path << " (" << matched << "/" << events << " events matched)\n";
+                if (diverged) {
+                    out << "Diverged: " << divergence << "\n";
+                } else if (finished) {
+                    out << "Replay matched the recording\n";
+                } else {
+                    out << "Replay in progress, ends at tick " << end_tick << "\n";
+                }
+                break;
+        }
+    }
+    
+private:
+    static bool parseHeader(const std::string& data, size_t& pos, uint64_t& seed, std::string& config_text) {
+        if (data.size() < 5 || data.compare(0, 4, magic()) != 0 || static_cast<uint8_t>(data[4]) != VERSION) {
+            return false;
+        }
+        pos = 5;
+        uint64_t length;
+        if (!snapshot_codec::getVarint(data, pos, seed) || !snapshot_codec::getVarint(data, pos, length) ||
+            length > data.size() - pos) {
+            return false;
+        }
+        config_text = data.substr(pos, length);
+        pos += length;
+        return true;
+    }
+    
+    void append(long long tick, TraceEvent event, int core, int process_id, const std::string& name) {
+        snapshot_codec::putVarint(buffer, static_cast<uint64_t>(tick - last_tick));
+        buffer.push_back(static_cast<char>(event));
+        snapshot_codec::putVarint(buffer, static_cast<uint64_t>(core + 1));
+        snapshot_codec::putVarint(buffer, static_cast<uint64_t>(process_id));
+        if (event == TraceEvent::ADMIT || event == TraceEvent::CREATE) {
+            snapshot_codec::putVarint(buffer, name.size());
+            buffer += name;
+        }
+        last_tick = tick;
+        events++;
+        
+        if (buffer.size() >= FLUSH_BYTES) {
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    
+    // Decodes the cursor's next event if it has not been decoded yet
+    bool peek(Cursor& cursor) const {
+        if (cursor.has_record) {
+            return true;
+        }
+        if (cursor.pos >= buffer.size()) {
+            return false;
+        }
+        
+        uint64_t delta, core, process_id;
+        size_t pos = cursor.pos;
+        if (!snapshot_codec::getVarint(buffer, pos, delta) || pos >= buffer.size()) {
+            return false;
+        }
+        TraceRecord& record = cursor.record;
+        record.event = static_cast<TraceEvent>(buffer[pos++]);
+        if (!snapshot_codec::getVarint(buffer, pos, core) || !snapshot_codec::getVarint(buffer, pos, process_id)) {
+            return false;
+        }
+        record.name.clear();
+        if (record.event == TraceEvent::ADMIT || record.event == TraceEvent::CREATE) {
+            uint64_t length;
+            if (!snapshot_codec::getVarint(buffer, pos, length) || length > buffer.size() - pos) {
+                return false;
+            }
+            record.name = buffer.substr(pos, length);
+            pos += length;
+        }
+        
+        cursor.tick += static_cast<long long>(delta);
+        record.tick = cursor.tick;
+        record.core = static_cast<int>(core) - 1;
+        record.process_id = static_cast<int>(process_id);
+        cursor.pos = pos;
+        cursor.has_record = true;
+        return true;
+    }
+    
+    void check(const TraceRecord& actual) {
+        if (!peek(expected)) {
+            diverged = true;
+            divergence = "recording ended before " + formatTraceRecord(actual);
+            return;
+        }
+        
+        const TraceRecord& want = expected.record;
+        if (want.tick != actual.tick || want.event != actual.event || want.core != actual.core ||
+            want.process_id != actual.process_id || want.name != actual.name) {
+            diverged = true;
+            divergence = "expected " + formatTraceRecord(want) + ", got " + formatTraceRecord(actual);
+            return;
+        }
+        expected.has_record = false;
+        matched++;
+    }
+};
+
+#endif
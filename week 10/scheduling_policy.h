@@ -0,0 +1,204 @@
+#ifndef SCHEDULING_POLICY_H
+#define SCHEDULING_POLICY_H
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include "process.h"
+#include "config.h"
+#include "ready_queue.h"
+#include "shortest_job_queue.h"
+
+typedef std::map<int, std::unique_ptr<Process>> ProcessTable; // Live processes by id
+
+// What the scheduler asks of a scheduling policy. The tick loop is a
+// template over the policy type, chosen once in Scheduler::initialize(),
+// so these are plain calls the compiler can inline, not virtual ones.
+// A policy derives from SchedulingPolicy, which has do-nothing defaults for
+// the event hooks, and hides the hooks it changes:
+//
+//   initialize(config)     Once, before the first tick
+//   push(process, core)    Process became ready: admitted, woken or preempted.
+//                          core is the one it last ran on, or -1
+//   pickNext(core)         Next process for an idle core, or nullptr
+//   empty()                No process is ready
+//   onDispatch(process)    Process got a core; returns its time slice in
+//                          ticks, 0 to run until it sleeps or finishes
+//   onTick(tick, table)    Every tick before dispatching, with no core
+//                          worker running
+//   onPreempt(process, quantum_expired)  Before a preempted process is pushed
+//   onSleep(process)       Process went to sleep
+//   onFinish(process)      Process ran its last instruction
+//
+// A policy with PREEMPTS_RUNNING set is also asked, after every tick, which
+// running process to give up first (highest preemptionRank()) and whether a
+// waiting process should take its core (shouldPreempt()).
+//
+// Hooks run on the scheduler thread, except pickNext() and onDispatch(),
+// which core workers call for their own core in parallel mode.
+class SchedulingPolicy {
+public:
+    static const bool PREEMPTS_RUNNING = false;
+    
+    int onDispatch(Process*) { return 0; }
+    void onTick(long long, ProcessTable&) {}
+    void onPreempt(Process*, bool) {}
+    void onSleep(Process*) {}
+    void onFinish(Process*) {}
+    
+    long long preemptionRank(const Process*) const { return 0; }
+    bool shouldPreempt(const Process*, int) const { return false; }
+};
+
+// Policies whose ready processes wait in the per-core FIFO lanes of a
+// ReadyQueue
+class LanePolicy : public SchedulingPolicy {
+protected:
+    ReadyQueue ready_queue;
+    
+public:
+    void initialize(const Config& config) {
+        ready_queue.initialize(config.ready_queue == "per-core" ? config.num_cpu : 1);
+    }
+    
+    void push(Process* process, int core) { ready_queue.push(process, core); }
+    Process* pickNext(int core) { return ready_queue.pop(core); }
+    bool empty() const { return ready_queue.empty(); }
+};
+
+// First Come First Serve: runs every process until it sleeps or finishes
+class FcfsPolicy : public LanePolicy {
+};
+
+// Round Robin: FIFO order, quantum_cycles ticks at a time
+class RoundRobinPolicy : public LanePolicy {
+private:
+    int quantum = 1;
+    
+public:
+    void initialize(const Config& config) {
+        LanePolicy::initialize(config);
+        quantum = std::max(1, config.quantum_cycles);
+    }
+    
+    int onDispatch(Process*) { return quantum; }
+};
+
+// Multi-level feedback queue. New processes start at level 0, the highest;
+// using up a quantum moves a process down a level, sleeping before that
+// keeps its level. A process waiting above a running one takes its core, and
+// every mlfq_boost_ticks ticks all processes go back to level 0 so the low
+// levels do not starve.
+class MlfqPolicy : public LanePolicy {
+private:
+    std::vector<int> level_quantums; // Time slice per level
+    int boost_ticks = 0;
+    
+public:
+    static const bool PREEMPTS_RUNNING = true;
+    
+    // A level without a quantum in mlfq-quantums gets double the one above;
+    // with none given, level 0 gets quantum_cycles
+    void initialize(const Config& config) {
+        int levels = std::max(1, config.mlfq_levels);
+        level_quantums.clear();
+        std::istringstream quantums(config.mlfq_quantums);
+        std::string quantum;
+        while (static_cast<int>(level_quantums.size()) < levels && std::getline(quantums, quantum, ',')) {
+            level_quantums.push_back(std::max(1, std::atoi(quantum.c_str())));
+        }
+        if (level_quantums.empty()) {
+            level_quantums.push_back(std::max(1, config.quantum_cycles));
+        }
+        while (static_cast<int>(level_quantums.size()) < levels) {
+            level_quantums.push_back(level_quantums.back() * 2);
+        }
+        
+        ready_queue.initialize(config.ready_queue == "per-core" ? config.num_cpu : 1, levels);
+        boost_ticks = config.mlfq_boost_ticks;
+    }
+    
+    const std::vector<int>& levelQuantums() const { return level_quantums; }
+    
+    int onDispatch(Process* process) {
+        return level_quantums[std::min(process->priority_level, ready_queue.levelCount() - 1)];
+    }
+    
+    // Priority boost: every live process back to the top level
+    void onTick(long long tick, ProcessTable& processes) {
+        if (boost_ticks > 0 && tick % boost_ticks == 0) {
+            for (auto& entry : processes) {
+                entry.second->priority_level = 0;
+            }
+            ready_queue.promoteAll();
+        }
+    }
+    
+    void onPreempt(Process* process, bool quantum_expired) {
+        if (quantum_expired) {
+            process->priority_level = std::min(process->priority_level + 1, ready_queue.levelCount() - 1);
+        }
+    }
+    
+    long long preemptionRank(const Process* process) const { return process->priority_level; }
+    
+    // Only if more processes wait above it than there are idle cores
+    bool shouldPreempt(const Process* running, int free_cores) const {
+        return ready_queue.waitingAbove(running->priority_level) > free_cores;
+    }
+};
+
+// Shortest Job First: the ready process with the fewest instructions left
+// (FOR loops expanded) runs next, until it sleeps or finishes. With
+// sjf_aging_ticks = N, every N ticks spent waiting count as one instruction
+// less, so long processes still get to run. Processes age at the same rate,
+// which makes remaining * N + ready_since_tick a key that never changes
+// while a process waits.
+class SjfPolicy : public SchedulingPolicy {
+protected:
+    ShortestJobQueue ready_queue;
+    int aging_ticks = 0;
+    
+    // Key of a process that has been ready since the given tick
+    long long keyOf(const Process* process, long long since) const {
+        long long remaining = process->remainingInstructions();
+        return aging_ticks > 0 ? remaining * aging_ticks + since : remaining;
+    }
+    
+public:
+    void initialize(const Config& config) {
+        ready_queue.clear();
+        aging_ticks = std::max(0, config.sjf_aging_ticks);
+    }
+    
+    void push(Process* process, int) { ready_queue.push(process, keyOf(process, process->ready_since_tick)); }
+    Process* pickNext(int) { return ready_queue.pop(); }
+    bool empty() const { return ready_queue.empty(); }
+};
+
+// Shortest Remaining Time First: SJF that also preempts the running process
+// with the most instructions left once a shorter one is waiting and no core
+// is idle. That is at most one preemption per tick.
+class SrtfPolicy : public SjfPolicy {
+private:
+    long long current_tick = 0;
+    
+public:
+    static const bool PREEMPTS_RUNNING = true;
+    
+    void onTick(long long tick, ProcessTable&) { current_tick = tick; }
+    
+    long long preemptionRank(const Process* process) const { return process->remainingInstructions(); }
+    
+    // The running process is keyed as if it had just become ready
+    bool shouldPreempt(const Process* running, int free_cores) const {
+        long long shortest;
+        return free_cores == 0 && ready_queue.peekKey(shortest) && shortest < keyOf(running, current_tick);
+    }
+};
+
+#endif
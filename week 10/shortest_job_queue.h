@@ -0,0 +1,80 @@
+#ifndef SHORTEST_JOB_QUEUE_H
+#define SHORTEST_JOB_QUEUE_H
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include "process.h"
+
+// Ready queue for SJF/SRTF: a binary min-heap of processes by key, so push
+// and pop are O(log n). Equal keys leave in the order they were pushed.
+// One mutex guards the heap, since core workers pop from it in parallel mode.
+class ShortestJobQueue {
+private:
+    struct Entry {
+        long long key;
+        unsigned long long sequence;
+        Process* process;
+    };
+    
+    // std heap functions keep the largest element first, so order by "later"
+    struct Later {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.key != b.key ? a.key > b.key : a.sequence > b.sequence;
+        }
+    };
+    
+    mutable std::mutex heap_mutex;
+    std::vector<Entry> heap;
+    unsigned long long next_sequence = 0;
+    std::atomic<int> total_size{0};
+    
+public:
+    void clear() {
+        std::lock_guard<std::mutex> lock(heap_mutex);
+        heap.clear();
+        next_sequence = 0;
+        total_size = 0;
+    }
+    
+    void push(Process* process, long long key) {
+        std::lock_guard<std::mutex> lock(heap_mutex);
+        heap.push_back(Entry{key, next_sequence++, process});
+        std::push_heap(heap.begin(), heap.end(), Later());
+        total_size++;
+    }
+    
+    // Process with the smallest key, or nullptr if none is waiting
+    Process* pop() {
+        if (total_size == 0) {
+            return nullptr;
+        }
+        
+        std::lock_guard<std::mutex> lock(heap_mutex);
+        if (heap.empty()) {
+            return nullptr;
+        }
+        
+        std::pop_heap(heap.begin(), heap.end(), Later());
+        Process* process = heap.back().process;
+        heap.pop_back();
+        total_size--;
+        return process;
+    }
+    
+    // Smallest key waiting; false if the queue is empty
+    bool peekKey(long long& key) const {
+        std::lock_guard<std::mutex> lock(heap_mutex);
+        if (heap.empty()) {
+            return false;
+        }
+        key = heap.front().key;
+        return true;
+    }
+    
+    bool empty() const { return total_size == 0; }
+    int size() const { return total_size; }
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "snapshot_codec.h"
+
+// Prints a binary memory snapshot stream in the memory_stamp text layout
+// usage: snapdump [memory_stamps.bin] [--last N]
+int main(int argc, char* argv[]) {
+    std::string path = "memory_stamps.bin";
+    long long last = -1;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--last" && i + 1 < argc) {
+            last = std::stoll(argv[++i]);
+        } else {
+            path = arg;
+        }
+    }
+    
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << path << "\n";
+        return 1;
+    }
+    if (!snapshot_codec::readStreamHeader(file)) {
+        std::cerr << path << " is not a memory snapshot stream\n";
+        return 1;
+    }
+    
+    // With --last, count the frames first so only the tail gets printed
+    long long skip = 0;
+    if (last >= 0) {
+        snapshot_codec::Decoder counter;
+        MemorySnapshot snapshot;
+        long long total = 0;
+        while (counter.next(file, snapshot)) {
+            total++;
+        }
+        skip = total > last ? total - last : 0;
+        file.clear();
+        file.seekg(0);
+        snapshot_codec::readStreamHeader(file);
+    }
+    
+    snapshot_codec::Decoder decoder;
+    MemorySnapshot snapshot;
+    long long index = 0;
+    while (decoder.next(file, snapshot)) {
+        if (index++ < skip) {
+            continue;
+        }
+        writeStampHeader(std::cout, snapshot);
+        writeSnapshotText(std::cout, snapshot);
+        std::cout << "\n";
+    }
+    
+    if (!file.eof()) {
+        std::cerr << "Stopped at a corrupt frame after " << index << " snapshots\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,327 @@
+#ifndef SNAPSHOT_CODEC_H
+#define SNAPSHOT_CODEC_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <istream>
+#include <ostream>
+#include "memory_snapshot.h"
+
+// Binary snapshot stream (memory_stamps.bin)
+//
+//   file   := "CSNP" version:u8 frame*
+//   frame  := length:u32le payload[length]
+//   payload:= flags:u8 sequence tick taken_at_ms processes_in_memory
+//             external_fragmentation total_memory page_faults
+//             keep_front keep_back changed region[changed]
+//   region := upper size owner label?   (owner 0 = free, else process id + 1;
+//                                        label only for allocated regions)
+//
+// Every number is a LEB128 varint. sequence, tick, taken_at_ms and the
+// scalar fields are zigzag deltas against the previous frame. The region
+// list is coded as the regions it shares with the previous frame at the
+// front and back, plus the changed middle. Labels go through a name table
+// that grows as new names appear (index == table size introduces a name).
+// A keyframe resets the previous frame and the name table, so a stream can
+// be decoded from any keyframe onward.
+namespace snapshot_codec {
+
+const char MAGIC[4] = {'C', 'S', 'N', 'P'};
+const uint8_t VERSION = 1;
+const uint8_t FLAG_KEYFRAME = 0x01;
+const uint64_t FREE_REGION = 0; // process_id is stored as id + 1
+const long long KEYFRAME_INTERVAL = 256;
+
+inline void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+inline void putSigned(std::string& out, long long value) {
+    putVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+inline bool getVarint(const std::string& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        uint8_t byte = static_cast<uint8_t>(in[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool getSigned(const std::string& in, size_t& pos, long long& value) {
+    uint64_t raw;
+    if (!getVarint(in, pos, raw)) {
+        return false;
+    }
+    value = static_cast<long long>((raw >> 1) ^ (~(raw & 1) + 1));
+    return true;
+}
+
+inline long long toMillis(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+inline bool sameRegion(const SnapshotRegion& a, const SnapshotRegion& b) {
+    return a.upper == b.upper && a.lower == b.lower && a.is_free == b.is_free &&
+           a.process_id == b.process_id && a.label == b.label;
+}
+
+// Scalar fields every frame carries, kept between frames for delta coding
+struct FrameHeader {
+    long long sequence = 0;
+    long long tick = 0;
+    long long taken_at_ms = 0;
+    long long processes_in_memory = 0;
+    long long external_fragmentation = 0;
+    long long total_memory = 0;
+    long long page_faults = -1;
+};
+
+inline FrameHeader headerOf(const MemorySnapshot& snapshot) {
+    FrameHeader header;
+    header.sequence = snapshot.sequence;
+    header.tick = snapshot.tick;
+    header.taken_at_ms = toMillis(snapshot.taken_at);
+    header.processes_in_memory = snapshot.processes_in_memory;
+    header.external_fragmentation = static_cast<long long>(snapshot.external_fragmentation);
+    header.total_memory = static_cast<long long>(snapshot.total_memory);
+    header.page_faults = snapshot.page_faults;
+    return header;
+}
+
+inline void writeStreamHeader(std::ostream& out) {
+    out.write(MAGIC, sizeof(MAGIC));
+    out.put(static_cast<char>(VERSION));
+}
+
+inline bool readStreamHeader(std::istream& in) {
+    char magic[4];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, MAGIC)) {
+        return false;
+    }
+    int version = in.get();
+    return version == VERSION;
+}
+
+class Encoder {
+private:
+    FrameHeader previous_header;
+    std::vector<SnapshotRegion> previous_regions;
+    std::vector<std::string> names;
+    long long frames_since_keyframe = KEYFRAME_INTERVAL;
+    std::string payload;
+
+public:
+    // Append one length-prefixed frame for the snapshot to out
+    void encode(const MemorySnapshot& snapshot, std::string& out) {
+        bool keyframe = frames_since_keyframe >= KEYFRAME_INTERVAL;
+        if (keyframe) {
+            previous_header = FrameHeader();
+            previous_regions.clear();
+            names.clear();
+            frames_since_keyframe = 0;
+        }
+        frames_since_keyframe++;
+        
+        FrameHeader header = headerOf(snapshot);
+        payload.clear();
+        payload.push_back(static_cast<char>(keyframe ? FLAG_KEYFRAME : 0));
+        putSigned(payload, header.sequence - previous_header.sequence);
+        putSigned(payload, header.tick - previous_header.tick);
+        putSigned(payload, header.taken_at_ms - previous_header.taken_at_ms);
+        putSigned(payload, header.processes_in_memory - previous_header.processes_in_memory);
+        putSigned(payload, header.external_fragmentation - previous_header.external_fragmentation);
+        putSigned(payload, header.total_memory - previous_header.total_memory);
+        putSigned(payload, header.page_faults - previous_header.page_faults);
+        
+        // Regions shared with the previous frame at both ends are not repeated
+        const std::vector<SnapshotRegion>& regions = snapshot.regions;
+        size_t limit = std::min(regions.size(), previous_regions.size());
+        size_t keep_front = 0;
+        while (keep_front < limit && sameRegion(regions[keep_front], previous_regions[keep_front])) {
+            keep_front++;
+        }
+        size_t keep_back = 0;
+        while (keep_back < limit - keep_front &&
+               sameRegion(regions[regions.size() - 1 - keep_back],
+                          previous_regions[previous_regions.size() - 1 - keep_back])) {
+            keep_back++;
+        }
+        size_t changed = regions.size() - keep_front - keep_back;
+        putVarint(payload, keep_front);
+        putVarint(payload, keep_back);
+        putVarint(payload, changed);
+        
+        for (size_t i = keep_front; i < keep_front + changed; i++) {
+            const SnapshotRegion& region = regions[i];
+            putVarint(payload, region.upper);
+            putVarint(payload, region.upper - region.lower);
+            putVarint(payload, region.is_free ? FREE_REGION : static_cast<uint64_t>(region.process_id) + 1);
+            if (!region.is_free) {
+                putLabel(region.label);
+            }
+        }
+        
+        uint32_t length = static_cast<uint32_t>(payload.size());
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<char>((length >> (8 * i)) & 0xFF));
+        }
+        out += payload;
+        
+        previous_header = header;
+        previous_regions = regions;
+    }
+
+private:
+    void putLabel(const std::string& label) {
+        // Scan from the newest names, those are the ones that repeat
+        for (size_t i = names.size(); i > 0; i--) {
+            if (names[i - 1] == label) {
+                putVarint(payload, i - 1);
+                return;
+            }
+        }
+        putVarint(payload, names.size());
+        putVarint(payload, label.size());
+        payload += label;
+        names.push_back(label);
+    }
+};
+
+class Decoder {
+private:
+    FrameHeader previous_header;
+    std::vector<SnapshotRegion> previous_regions;
+    std::vector<std::string> names;
+    bool synced = false; // Seen a keyframe yet
+    std::string payload;
+
+public:
+    // Read the next frame; false at end of stream or on a corrupt frame
+    bool next(std::istream& in, MemorySnapshot& snapshot) {
+        while (true) {
+            unsigned char length_bytes[4];
+            if (!in.read(reinterpret_cast<char*>(length_bytes), 4)) {
+                return false;
+            }
+            uint32_t length = 0;
+            for (int i = 0; i < 4; i++) {
+                length |= static_cast<uint32_t>(length_bytes[i]) << (8 * i);
+            }
+            payload.resize(length);
+            if (length == 0 || !in.read(&payload[0], length)) {
+                return false;
+            }
+            
+            bool keyframe = (static_cast<uint8_t>(payload[0]) & FLAG_KEYFRAME) != 0;
+            if (!keyframe && !synced) {
+                continue; // Deltas before the first keyframe cannot be resolved
+            }
+            return decodePayload(keyframe, snapshot);
+        }
+    }
+
+private:
+    bool decodePayload(bool keyframe, MemorySnapshot& snapshot) {
+        if (keyframe) {
+            previous_header = FrameHeader();
+            previous_regions.clear();
+            names.clear();
+            synced = true;
+        }
+        
+        size_t pos = 1;
+        FrameHeader header;
+        long long delta;
+        long long* fields[] = {&header.sequence, &header.tick, &header.taken_at_ms,
+                               &header.processes_in_memory, &header.external_fragmentation,
+                               &header.total_memory, &header.page_faults};
+        const long long* previous_fields[] = {&previous_header.sequence, &previous_header.tick,
+                                              &previous_header.taken_at_ms, &previous_header.processes_in_memory,
+                                              &previous_header.external_fragmentation,
+                                              &previous_header.total_memory, &previous_header.page_faults};
+        for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+            if (!getSigned(payload, pos, delta)) {
+                return false;
+            }
+            *fields[i] = *previous_fields[i] + delta;
+        }
+        
+        uint64_t keep_front, keep_back, changed;
+        if (!getVarint(payload, pos, keep_front) || !getVarint(payload, pos, keep_back) ||
+            !getVarint(payload, pos, changed) || keep_front + keep_back > previous_regions.size()) {
+            return false;
+        }
+        
+        std::vector<SnapshotRegion> regions(previous_regions.begin(), previous_regions.begin() + keep_front);
+        for (uint64_t i = 0; i < changed; i++) {
+            uint64_t upper, size, owner;
+            if (!getVarint(payload, pos, upper) || !getVarint(payload, pos, size) ||
+                !getVarint(payload, pos, owner) || size > upper) {
+                return false;
+            }
+            SnapshotRegion region;
+            region.upper = static_cast<size_t>(upper);
+            region.lower = static_cast<size_t>(upper - size);
+            region.is_free = owner == FREE_REGION;
+            region.process_id = region.is_free ? -1 : static_cast<int>(owner - 1);
+            if (!region.is_free && !getLabel(pos, region.label)) {
+                return false;
+            }
+            regions.push_back(std::move(region));
+        }
+        regions.insert(regions.end(), previous_regions.end() - keep_back, previous_regions.end());
+        
+        snapshot.sequence = header.sequence;
+        snapshot.tick = header.tick;
+        snapshot.taken_at = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::milliseconds(header.taken_at_ms)));
+        snapshot.processes_in_memory = static_cast<int>(header.processes_in_memory);
+        snapshot.external_fragmentation = static_cast<size_t>(header.external_fragmentation);
+        snapshot.total_memory = static_cast<size_t>(header.total_memory);
+        snapshot.page_faults = header.page_faults;
+        snapshot.regions = regions;
+        
+        previous_header = header;
+        previous_regions.swap(regions);
+        return true;
+    }
+    
+    bool getLabel(size_t& pos, std::string& label) {
+        uint64_t index;
+        if (!getVarint(payload, pos, index) || index > names.size()) {
+            return false;
+        }
+        if (index < names.size()) {
+            label = names[index];
+            return true;
+        }
+        uint64_t size;
+        if (!getVarint(payload, pos, size) || size > payload.size() - pos) {
+            return false;
+        }
+        label.assign(payload, pos, static_cast<size_t>(size));
+        pos += static_cast<size_t>(size);
+        names.push_back(label);
+        return true;
+    }
+};
+    
+} // namespace snapshot_codec
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef SNAPSHOT_WRITER_H
+#define SNAPSHOT_WRITER_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <iterator>
+#include "memory_snapshot.h"
+#include "snapshot_codec.h"
+
+// Background thread that appends memory snapshots to a single file. The
+// scheduler hands snapshots over a bounded queue and never waits on disk:
+// when the queue is full the snapshot is dropped and counted instead.
+// Snapshots go out as text (memory_stamps.txt) or as the delta-encoded
+// binary stream from snapshot_codec.h (memory_stamps.bin, read by snapdump).
+class SnapshotWriter {
+private:
+    std::string path;
+    bool binary;
+    size_t capacity;
+    std::deque<MemorySnapshot> pending;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::thread writer_thread;
+    bool stopping = false;
+    std::atomic<long long> written{0};
+    std::atomic<long long> dropped{0};
+    
+public:
+    explicit SnapshotWriter(const std::string& file_path = "memory_stamps.bin", bool binary_format = true,
+                            size_t max_pending = 256)
+        : path(file_path), binary(binary_format), capacity(max_pending) {}
+    
+    ~SnapshotWriter() { stop(); }
+    
+    // Only takes effect on the next start()
+    void setFormat(const std::string& format) {
+        binary = format != "text";
+        path = binary ? "memory_stamps.bin" : "memory_stamps.txt";
+    }
+    
+    void start() {
+        if (writer_thread.joinable()) {
+            return;
+        }
+        stopping = false;
+        writer_thread = std::thread(&SnapshotWriter::writerLoop, this);
+    }
+    
+    // Write out everything still queued, then stop the thread
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            stopping = true;
+        }
+        queue_cv.notify_one();
+        if (writer_thread.joinable()) {
+            writer_thread.join();
+        }
+    }
+    
+    // Never blocks on I/O; returns false if the snapshot had to be dropped
+    bool submit(MemorySnapshot&& snapshot) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (pending.size() >= capacity) {
+                dropped++;
+                return false;
+            }
+            pending.push_back(std::move(snapshot));
+        }
+        queue_cv.notify_one();
+        return true;
+    }
+    
+    long long snapshotsWritten() const { return written; }
+    long long snapshotsDropped() const { return dropped; }
+    
+private:
+    void writerLoop() {
+        std::ios::openmode mode = std::ios::out | std::ios::app;
+        if (binary) {
+            mode |= std::ios::binary;
+        }
+        std::ofstream file(path, mode);
+        snapshot_codec::Encoder encoder;
+        std::string encoded;
+        std::vector<MemorySnapshot> batch;
+        
+        // A new encoder always opens with a keyframe, so later runs can simply
+        // append to the same stream
+        file.seekp(0, std::ios::end);
+        if (binary && file.tellp() == 0) {
+            snapshot_codec::writeStreamHeader(file);
+        }
+        
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex);
+                queue_cv.wait(lock, [this] { return stopping || !pending.empty(); });
+                if (pending.empty() && stopping) {
+                    break;
+                }
+                
+                // Take everything queued so far as one batch
+                batch.assign(std::make_move_iterator(pending.begin()),
+                             std::make_move_iterator(pending.end()));
+                pending.clear();
+            }
+            
+            // One write per batch for the binary stream
+            if (binary) {
+                encoded.clear();
+                for (const MemorySnapshot& snapshot : batch) {
+                    encoder.encode(snapshot, encoded);
+                }
+                file.write(encoded.data(), encoded.size());
+            } else {
+                for (const MemorySnapshot& snapshot : batch) {
+                    writeStampHeader(file, snapshot);
+                    writeSnapshotText(file, snapshot);
+                    file << "\n";
+                }
+            }
+            file.flush();
+            written += batch.size();
+            batch.clear();
+        }
+    }
+};
+
+#endif
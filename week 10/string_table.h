@@ -0,0 +1,144 @@
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <cctype>
+#include <functional>
+
+// Append-only table of interned strings. Equal strings get the same 32-bit
+// id and share one copy for the rest of the run. Interning takes a lock;
+// looking an id up does not, since entries never move once published.
+class StringTable {
+private:
+    static const size_t CHUNK_BITS = 12;
+    static const size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static const size_t MAX_CHUNKS = 1 << 14; // 64M strings
+    
+    struct Entry {
+        std::string text;
+        int32_t literal; // Value of an all-digit string, or -1
+    };
+    
+    // The index points at the entries' own text, so each string is stored once
+    struct TextHash {
+        size_t operator()(const std::string* text) const { return std::hash<std::string>()(*text); }
+    };
+    struct TextEqual {
+        bool operator()(const std::string* a, const std::string* b) const { return *a == *b; }
+    };
+    
+    std::mutex intern_mutex;
+    std::unordered_map<const std::string*, uint32_t, TextHash, TextEqual> ids;
+    std::unique_ptr<std::atomic<Entry*>[]> chunks;
+    uint32_t next_id = 0;
+    
+public:
+    StringTable() : chunks(new std::atomic<Entry*>[MAX_CHUNKS]) {
+        for (size_t i = 0; i < MAX_CHUNKS; i++) {
+            chunks[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    
+    ~StringTable() {
+        for (size_t i = 0; i < MAX_CHUNKS; i++) {
+            delete[] chunks[i].load(std::memory_order_relaxed);
+        }
+    }
+    
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+    
+    uint32_t intern(const std::string& value) {
+        std::lock_guard<std::mutex> lock(intern_mutex);
+        auto it = ids.find(&value);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        
+        // Fail before writing past the chunk array
+        if ((next_id >> CHUNK_BITS) >= MAX_CHUNKS) {
+            throw std::length_error("symbol table is full");
+        }
+        uint32_t id = next_id++;
+        Entry* chunk = chunks[id >> CHUNK_BITS].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Entry[CHUNK_SIZE];
+        }
+        Entry& entry = chunk[id & (CHUNK_SIZE - 1)];
+        entry.text = value;
+        entry.literal = parseLiteral(value);
+        // Publishes the entry too: readers only hold ids handed out after this
+        chunks[id >> CHUNK_BITS].store(chunk, std::memory_order_release);
+        ids.emplace(&entry.text, id);
+        return id;
+    }
+    
+    const std::string& text(uint32_t id) const {
+        return entry(id).text;
+    }
+    
+    // Numeric value of a literal symbol such as "42", -1 for names
+    int32_t literal(uint32_t id) const {
+        return entry(id).literal;
+    }
+    
+private:
+    const Entry& entry(uint32_t id) const {
+        return chunks[id >> CHUNK_BITS].load(std::memory_order_acquire)[id & (CHUNK_SIZE - 1)];
+    }
+    
+    static int32_t parseLiteral(const std::string& value) {
+        if (value.empty() || value.size() > 9) {
+            return -1;
+        }
+        int32_t result = 0;
+        for (char c : value) {
+            if (!std::isdigit(static_cast<unsigned char>(c))) {
+                return -1;
+            }
+            result = result * 10 + (c - '0');
+        }
+        return result;
+    }
+};
+
+// Every string an instruction refers to: PRINT messages and numeric
+// literals, shared by all processes
+inline StringTable& symbolTable() {
+    static StringTable table;
+    return table;
+}
+
+// Ids of prefix + number ("7" with no prefix), cached so the
+// generator does not build and hash a string per instruction. Keep one per
+// thread; the table behind it is shared.
+class NumberedSymbols {
+private:
+    std::string prefix;
+    std::vector<uint32_t> ids;
+    std::vector<char> known;
+    
+public:
+    explicit NumberedSymbols(const std::string& symbol_prefix) : prefix(symbol_prefix) {}
+    
+    uint32_t get(size_t number) {
+        if (number >= ids.size()) {
+            ids.resize(number + 1);
+            known.resize(number + 1, 0);
+        }
+        if (!known[number]) {
+            ids[number] = symbolTable().intern(prefix + std::to_string(number));
+            known[number] = 1;
+        }
+        return ids[number];
+    }
+};
+
+#endif
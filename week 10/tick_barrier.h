@@ -0,0 +1,44 @@
+#ifndef TICK_BARRIER_H
+#define TICK_BARRIER_H
+
+#include <mutex>
+#include <condition_variable>
+
+// Reusable barrier used to line up the scheduler thread and the per-core
+// worker threads at the start and end of every CPU tick.
+class TickBarrier {
+private:
+    std::mutex barrier_mutex;
+    std::condition_variable barrier_cv;
+    int parties;
+    int arrived;
+    long long generation;
+
+public:
+    explicit TickBarrier(int count = 1) : parties(count), arrived(0), generation(0) {}
+
+    void reset(int count) {
+        std::lock_guard<std::mutex> lock(barrier_mutex);
+        parties = count;
+        arrived = 0;
+    }
+
+    // Block until every party has arrived for the current generation
+    void arriveAndWait() {
+        std::unique_lock<std::mutex> lock(barrier_mutex);
+        long long current_generation = generation;
+
+        if (++arrived == parties) {
+            arrived = 0;
+            generation++;
+            barrier_cv.notify_all();
+            return;
+        }
+
+        barrier_cv.wait(lock, [this, current_generation] {
+            return generation != current_generation;
+        });
+    }
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+#include <chrono>
+#include <ostream>
+#include <iomanip>
+#include <cstdint>
+#include <atomic>
+#include "latency_histogram.h"
+
+// Parts of a scheduler tick, in the order they run
+enum class TickPhase {
+    GENERATE,  // Fast mode: topping up and waiting on the generator pool
+    LOCK,      // Waiting for scheduler_mutex
+    ADMIT,     // Admitting new processes
+    MEMORY,    // manageMemory()
+    SCHEDULE,  // scheduleProcess()
+    EXECUTE,   // executeProcesses(), including waking sleepers
+    RETIRE,    // retireFinishedProcesses()
+    PUBLISH,   // publishStats()
+    SNAPSHOT,  // Capturing and queueing the memory snapshot
+    TICK,      // The whole tick
+    COUNT
+};
+
+inline const char* tickPhaseName(TickPhase phase) {
+    switch (phase) {
+        case TickPhase::GENERATE: return "generate";
+        case TickPhase::LOCK: return "lock";
+        case TickPhase::ADMIT: return "admit";
+        case TickPhase::MEMORY: return "memory";
+        case TickPhase::SCHEDULE: return "schedule";
+        case TickPhase::EXECUTE: return "execute";
+        case TickPhase::RETIRE: return "retire";
+        case TickPhase::PUBLISH: return "publish";
+        case TickPhase::SNAPSHOT: return "snapshot";
+        case TickPhase::TICK: return "tick";
+        case TickPhase::COUNT: break;
+    }
+    return "?";
+}
+
+// Latency histogram per tick phase. The scheduler thread times each phase
+// with lap(), one clock read per phase boundary; report-perf reads the
+// histograms from the CLI thread while ticks keep running.
+class TickProfiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+    static const int PHASES = static_cast<int>(TickPhase::COUNT);
+    
+private:
+    LatencyHistogram histograms[PHASES];
+    std::atomic<bool> reset_requested{false};
+    
+public:
+    // Start of a tick; also where a reset asked for by another thread happens,
+    // so the histograms are only ever written by the scheduler thread
+    Clock::time_point startTick() {
+        if (reset_requested.exchange(false, std::memory_order_relaxed)) {
+            for (LatencyHistogram& histogram : histograms) {
+                histogram.reset();
+            }
+        }
+        return Clock::now();
+    }
+    
+    void requestReset() {
+        reset_requested.store(true, std::memory_order_relaxed);
+    }
+    
+    // Records the time since `since` for the phase and returns the current
+    // time, which starts the next phase
+    Clock::time_point lap(TickPhase phase, Clock::time_point since) {
+        Clock::time_point current = Clock::now();
+        record(phase, since, current);
+        return current;
+    }
+    
+    void record(TickPhase phase, Clock::time_point start, Clock::time_point end) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        histograms[static_cast<int>(phase)].record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+    }
+    
+    const LatencyHistogram& histogram(TickPhase phase) const {
+        return histograms[static_cast<int>(phase)];
+    }
+    
+    // One row per phase, times in microseconds
+    void print(std::ostream& out) const {
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        
+        out << std::left << std::setw(10) << "phase" << std::right
+            << std::setw(12) << "count" << std::setw(12) << "mean us" << std::setw(12) << "p50 us"
+            << std::setw(12) << "p99 us" << std::setw(12) << "max us" << "\n";
+        out << std::fixed << std::setprecision(2);
+        for (int i = 0; i < PHASES; i++) {
+            const LatencyHistogram& histogram = histograms[i];
+            out << std::left << std::setw(10) << tickPhaseName(static_cast<TickPhase>(i)) << std::right
+                << std::setw(12) << histogram.count()
+                << std::setw(12) << histogram.mean() / 1000.0
+                << std::setw(12) << histogram.percentile(50) / 1000.0
+                << std::setw(12) << histogram.percentile(99) / 1000.0
+                << std::setw(12) << histogram.max() / 1000.0 << "\n";
+        }
+        
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <vector>
+#include <cstddef>
+
+// Hierarchical timer wheel keyed by absolute tick. Level 0 has one slot per
+// tick; every higher level covers 64 times the span of the one below and
+// its slots are cascaded down as time reaches them. Timers that are not due
+// cost nothing per tick: advance() only touches the slot for the new tick
+// and, every 64 ticks, one slot of the next level.
+template <typename T>
+class TimerWheel {
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4; // 64^4 ticks ahead before the overflow list
+    
+    struct Timer {
+        T item;
+        long long due_tick;
+    };
+    
+    std::vector<Timer> slots[LEVELS][SLOTS];
+    std::vector<Timer> overflow;
+    std::vector<Timer> cascading;
+    long long current_tick;
+    size_t timer_count;
+    
+public:
+    TimerWheel() : current_tick(0), timer_count(0) {}
+    
+    // Fire item once advance() reaches due_tick (or on the next advance if it
+    // is already due)
+    void schedule(const T& item, long long due_tick) {
+        timer_count++;
+        place(Timer{item, due_tick > current_tick ? due_tick : current_tick + 1});
+    }
+    
+    // Move time forward to now, calling on_due for every timer that expires,
+    // in tick order and then insertion order
+    template <typename Callback>
+    void advance(long long now, Callback on_due) {
+        while (current_tick < now) {
+            current_tick++;
+            
+            // Pull down the timers of every level whose slot boundary we
+            // crossed, highest first so nothing lands in an emptied slot
+            int top_level = 0;
+            while (top_level + 1 < LEVELS &&
+                   current_tick % (1LL << (SLOT_BITS * (top_level + 1))) == 0) {
+                top_level++;
+            }
+            if (top_level == LEVELS - 1) {
+                cascade(overflow);
+            }
+            for (int level = top_level; level >= 1; level--) {
+                cascade(slots[level][slotIndex(current_tick, level)]);
+            }
+            
+            std::vector<Timer>& due = slots[0][slotIndex(current_tick, 0)];
+            for (size_t i = 0; i < due.size(); i++) {
+                timer_count--;
+                on_due(due[i].item);
+            }
+            due.clear();
+        }
+    }
+    
+    size_t size() const { return timer_count; }
+    
+private:
+    static int slotIndex(long long tick, int level) {
+        return static_cast<int>((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+    }
+    
+    // due_tick is never behind current_tick here; a timer due right now goes
+    // into the level 0 slot that advance() is about to fire
+    void place(const Timer& timer) {
+        long long delta = timer.due_tick - current_tick;
+        
+        for (int level = 0; level < LEVELS; level++) {
+            long long span = 1LL << (SLOT_BITS * (level + 1));
+            if (delta < span) {
+                slots[level][slotIndex(timer.due_tick, level)].push_back(timer);
+                return;
+            }
+        }
+        overflow.push_back(timer);
+    }
+    
+    void cascade(std::vector<Timer>& bucket) {
+        cascading.swap(bucket);
+        for (const Timer& timer : cascading) {
+            place(timer);
+        }
+        cascading.clear();
+    }
+};
+
+#endif